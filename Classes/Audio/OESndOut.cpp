@@ -8,7 +8,27 @@
 #include "SPU2/interpolate_table.h"
 
 #include "common/Assertions.h"
+#include "common/Console.h"
+#include "common/Timer.h"
 #include "OESndOut.h"
+#include "VMManager.h"
+
+#include "SoundTouch.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+#if defined(_M_X86)
+#include <immintrin.h>
+#elif defined(_M_ARM64)
+#include <arm_neon.h>
+#endif
 
 static const s32 tbl_XA_Factor[16][2] =
 	{
@@ -50,37 +70,211 @@ static void __forceinline XA_decode_block(s16* buffer, const s16* block, s32& pr
 	}
 }
 
-static void __forceinline IncrementNextA(V_Core& thiscore, uint voiceidx)
+// --------------------------------------------------------------------------------------
+//  IRQ watch
+// --------------------------------------------------------------------------------------
+// IRQA and IRQEnable only change through register writes, which happen between mix ticks.
+// So UpdateIrqWatch() snapshots them once per tick into the list of addresses that are
+// armed right now. With no IRQ armed (most of the time), every address check in the mixer
+// is one branch that always goes the same way. Otherwise it's one compare per armed core.
+// GetIrqDistance() answers how far a voice can advance before it reaches any armed address.
+
+struct IrqWatch
 {
-	V_Voice& vc(thiscore.Voices[voiceidx]);
+	u32 Count;
+	u32 Addr[2];
+	u32 Core[2];
+	u32 Generation; ///< Bumped whenever the armed set changes.
+};
 
-	// Important!  Both cores signal IRQ when an address is read, regardless of
-	// which core actually reads the address.
+static IrqWatch s_irq_watch;
 
-	for (int i = 0; i < 2; i++)
+static void UpdateIrqWatch()
+{
+	IrqWatch watch = {};
+	for (u32 i = 0; i < 2; i++)
 	{
-		if (Cores[i].IRQEnable && (vc.NextA == Cores[i].IRQA))
+		if (Cores[i].IRQEnable)
 		{
-			//if( IsDevBuild )
-			//	ConLog(" * SPU2 Core %d: IRQ Requested (IRQA (%05X) passed; voice %d).\n", i, Cores[i].IRQA, thiscore.Index * 24 + voiceidx);
-
-			SetIrqCall(i);
+			watch.Addr[watch.Count] = Cores[i].IRQA;
+			watch.Core[watch.Count] = i;
+			watch.Count++;
 		}
 	}
 
+	if (watch.Count != s_irq_watch.Count || std::memcmp(watch.Addr, s_irq_watch.Addr, sizeof(u32) * watch.Count) != 0 ||
+		std::memcmp(watch.Core, s_irq_watch.Core, sizeof(u32) * watch.Count) != 0)
+	{
+		watch.Generation = s_irq_watch.Generation + 1;
+		s_irq_watch = watch;
+	}
+}
+
+static __forceinline void CheckIrqWatch(u32 addr)
+{
+	for (u32 i = 0; i < s_irq_watch.Count; i++)
+	{
+		if (addr == s_irq_watch.Addr[i])
+			SetIrqCall(s_irq_watch.Core[i]);
+	}
+}
+
+/// Number of words from \p addr up to, not including, the next armed IRQ address.
+/// 0 if \p addr itself is armed, 0x100000 (all of SPU2 RAM) if nothing is.
+static __forceinline u32 GetIrqDistance(u32 addr)
+{
+	u32 distance = 0x100000;
+	for (u32 i = 0; i < s_irq_watch.Count; i++)
+		distance = std::min<u32>(distance, (s_irq_watch.Addr[i] - addr) & 0xFFFFF);
+
+	return distance;
+}
+
+static void __forceinline IncrementNextA(V_Core& thiscore, uint voiceidx)
+{
+	V_Voice& vc(thiscore.Voices[voiceidx]);
+
+	// Important!  Both cores signal IRQ when an address is read, regardless of
+	// which core actually reads the address.
+
+	CheckIrqWatch(vc.NextA);
+
 	vc.NextA++;
 	vc.NextA &= 0xFFFFF;
 }
 
-// decoded pcm data, used to cache the decoded data so that it needn't be decoded
-// multiple times.  Cache chunks are decoded when the mixer requests the blocks, and
-// invalided when DMA transfers and memory writes are performed.
+// Still invalidated by the DMA and register write code in SPU2, but the mixer uses the
+// decode cache below instead.
 PcmCacheEntry pcm_cache_data[pcm_BlockCount];
 
 int g_counter_cache_hits = 0;
 int g_counter_cache_misses = 0;
 int g_counter_cache_ignores = 0;
 
+// --------------------------------------------------------------------------------------
+//  ADPCM decode cache
+// --------------------------------------------------------------------------------------
+// Decoded blocks are keyed by (block, prev1, prev2) in a 4-way set-associative cache with
+// 4096 sets per core, so 8192 sets and 32768 entries across both cores. Each entry also
+// keeps the 16 bytes of ADPCM it was decoded from. A hit compares them against what is in
+// SPU2 RAM now, so any write to the block makes the entry stale, whatever wrote it. That
+// makes every block cacheable, including the dynamic region below SPU2_DYN_MEMLINE,
+// without needing invalidation from the DMA code.
+//
+// Voices decode into and read from their own sample buffer. A cache entry can be evicted
+// or refilled while a voice is still partway through the block, and that must not change
+// what the voice plays.
+//
+// Each core has a cache, an LRU clock and hit counters of its own. The counts are folded
+// into g_stats after each tick.
+
+struct DecodeCacheWay
+{
+	u64 Source[2];
+	u32 Block; ///< Block index + 1, or 0 if the way is empty.
+	u32 LastUse;
+	s32 Prev1;
+	s32 Prev2;
+	bool Predecoded; ///< Filled in by PredecodeVoiceBlocks, and not fetched since.
+	s16 Samples[pcm_DecodedSamplesPerBlock];
+};
+
+static constexpr uint DecodeCacheWays = 4;
+static constexpr uint DecodeCacheSets = 4096; ///< Per core, 8192 across both.
+
+struct DecodeCacheSet
+{
+	DecodeCacheWay Ways[DecodeCacheWays];
+};
+
+static DecodeCacheSet s_decode_cache[2][DecodeCacheSets];
+static u32 s_decode_cache_clock[2] = {};
+static s16 s_voice_samples[2][V_Core::NumVoices][pcm_DecodedSamplesPerBlock];
+
+enum class DecodeCacheResult
+{
+	Hit,
+	Miss,
+	Stale, ///< The block was cached with this history, but has been written since.
+	Predecoded, ///< A hit on a block PredecodeVoiceBlocks decoded ahead of the fetch.
+	Count,
+};
+
+static u32 s_decode_cache_counts[2][static_cast<uint>(DecodeCacheResult::Count)] = {};
+
+static __forceinline DecodeCacheWay* DecodeCacheFind(uint coreidx, u32 block, const s16* memptr, s32 prev1, s32 prev2, DecodeCacheResult* result)
+{
+	u64 source[2];
+	std::memcpy(source, memptr, sizeof(source));
+
+	DecodeCacheSet& set = s_decode_cache[coreidx][block % DecodeCacheSets];
+	DecodeCacheWay* victim = &set.Ways[0];
+	for (DecodeCacheWay& way : set.Ways)
+	{
+		if (way.Block == block + 1 && way.Prev1 == prev1 && way.Prev2 == prev2)
+		{
+			const bool fresh = (way.Source[0] == source[0] && way.Source[1] == source[1]);
+			*result = fresh ? DecodeCacheResult::Hit : DecodeCacheResult::Stale;
+			victim = &way;
+			break;
+		}
+
+		// Empty ways have LastUse 0, so they go first.
+		if (way.LastUse < victim->LastUse)
+			victim = &way;
+	}
+
+	if (victim->Block != block + 1 || victim->Prev1 != prev1 || victim->Prev2 != prev2)
+		*result = DecodeCacheResult::Miss;
+
+	// On a miss or stale entry, the caller fills in the samples.
+	if (*result != DecodeCacheResult::Hit)
+	{
+		victim->Source[0] = source[0];
+		victim->Source[1] = source[1];
+		victim->Block = block + 1;
+		victim->Prev1 = prev1;
+		victim->Prev2 = prev2;
+		victim->Predecoded = false;
+	}
+
+	victim->LastUse = ++s_decode_cache_clock[coreidx];
+	return victim;
+}
+
+static __forceinline void CountDecodeCacheResult(uint coreidx, DecodeCacheResult result)
+{
+	s_decode_cache_counts[coreidx][static_cast<uint>(result)]++;
+}
+
+static void FlushDecodeCacheCounts()
+{
+	u32 counts[static_cast<uint>(DecodeCacheResult::Count)];
+	for (uint i = 0; i < std::size(counts); i++)
+	{
+		counts[i] = s_decode_cache_counts[0][i] + s_decode_cache_counts[1][i];
+		s_decode_cache_counts[0][i] = 0;
+		s_decode_cache_counts[1][i] = 0;
+	}
+
+	const auto add = [](std::atomic<u64>& counter, u32 count) {
+		if (count != 0)
+			counter.store(counter.load(std::memory_order_relaxed) + count, std::memory_order_relaxed);
+	};
+	add(OESndOut::g_stats.CacheHits, counts[static_cast<uint>(DecodeCacheResult::Hit)]);
+	add(OESndOut::g_stats.CacheMisses, counts[static_cast<uint>(DecodeCacheResult::Miss)]);
+	add(OESndOut::g_stats.CacheStale, counts[static_cast<uint>(DecodeCacheResult::Stale)]);
+	add(OESndOut::g_stats.CachePredecoded, counts[static_cast<uint>(DecodeCacheResult::Predecoded)]);
+
+	if (IsDevBuild)
+	{
+		// Predecoded blocks were still decoded for this fetch, just earlier.
+		g_counter_cache_hits += counts[static_cast<uint>(DecodeCacheResult::Hit)];
+		g_counter_cache_misses += counts[static_cast<uint>(DecodeCacheResult::Miss)] + counts[static_cast<uint>(DecodeCacheResult::Predecoded)];
+		g_counter_cache_ignores += counts[static_cast<uint>(DecodeCacheResult::Stale)];
+	}
+}
+
 // LOOP/END sets the ENDX bit and sets NAX to LSA, and the voice is muted if LOOP is not set
 // LOOP seems to only have any effect on the block with LOOP/END set, where it prevents muting the voice
 // (the documented requirement that every block in a loop has the LOOP bit set is nonsense according to tests)
@@ -126,9 +320,7 @@ static __forceinline s32 GetNextDataBuffered(V_Core& thiscore, uint voiceidx)
 
 		// We'll need the loop flags and buffer pointers regardless of cache status:
 
-		for (int i = 0; i < 2; i++)
-			if (Cores[i].IRQEnable && Cores[i].IRQA == (vc.NextA & 0xFFFF8))
-				SetIrqCall(i);
+		CheckIrqWatch(vc.NextA & 0xFFFF8);
 
 		s16* memptr = GetMemPtr(vc.NextA & 0xFFFF8);
 		vc.LoopFlags = *memptr >> 8; // grab loop flags from the upper byte.
@@ -138,43 +330,30 @@ static __forceinline s32 GetNextDataBuffered(V_Core& thiscore, uint voiceidx)
 			vc.LoopStartA = vc.NextA & 0xFFFF8;
 		}
 
-		const int cacheIdx = vc.NextA / pcm_WordsPerBlock;
-		PcmCacheEntry& cacheLine = pcm_cache_data[cacheIdx];
-		vc.SBuffer = cacheLine.Sampledata;
+		vc.SBuffer = s_voice_samples[thiscore.Index][voiceidx];
 
-		if (cacheLine.Validated && vc.Prev1 == cacheLine.Prev1 && vc.Prev2 == cacheLine.Prev2)
+		DecodeCacheResult result;
+		DecodeCacheWay* way = DecodeCacheFind(thiscore.Index, vc.NextA / pcm_WordsPerBlock, memptr, vc.Prev1, vc.Prev2, &result);
+		if (result == DecodeCacheResult::Hit)
 		{
-			// Cached block!  Read from the cache directly.
-			// Make sure to propagate the prev1/prev2 ADPCM:
-
+			// Cached block!  Make sure to propagate the prev1/prev2 ADPCM:
+			std::memcpy(vc.SBuffer, way->Samples, sizeof(way->Samples));
 			vc.Prev1 = vc.SBuffer[27];
 			vc.Prev2 = vc.SBuffer[26];
 
-			//ConLog( "* SPU2: Cache Hit! NextA=0x%x, cacheIdx=0x%x\n", vc.NextA, cacheIdx );
-
-			if (IsDevBuild)
-				g_counter_cache_hits++;
+			if (way->Predecoded)
+			{
+				result = DecodeCacheResult::Predecoded;
+				way->Predecoded = false;
+			}
 		}
 		else
 		{
-			// Only flag the cache if it's a non-dynamic memory range.
-			if (vc.NextA >= SPU2_DYN_MEMLINE)
-			{
-				cacheLine.Validated = true;
-				cacheLine.Prev1 = vc.Prev1;
-				cacheLine.Prev2 = vc.Prev2;
-			}
-
-			if (IsDevBuild)
-			{
-				if (vc.NextA < SPU2_DYN_MEMLINE)
-					g_counter_cache_ignores++;
-				else
-					g_counter_cache_misses++;
-			}
-
 			XA_decode_block(vc.SBuffer, memptr, vc.Prev1, vc.Prev2);
+			std::memcpy(way->Samples, vc.SBuffer, sizeof(way->Samples));
 		}
+
+		CountDecodeCacheResult(thiscore.Index, result);
 	}
 
 	return vc.SBuffer[vc.SCurrent++];
@@ -199,9 +378,7 @@ static __forceinline void GetNextDataDummy(V_Core& thiscore, uint voiceidx)
 
 	if (vc.SCurrent == 28)
 	{
-		for (int i = 0; i < 2; i++)
-			if (Cores[i].IRQEnable && Cores[i].IRQA == (vc.NextA & 0xFFFF8))
-				SetIrqCall(i);
+		CheckIrqWatch(vc.NextA & 0xFFFF8);
 
 		vc.LoopFlags = *GetMemPtr(vc.NextA & 0xFFFF8) >> 8; // grab loop flags from the upper byte.
 
@@ -215,6 +392,315 @@ static __forceinline void GetNextDataDummy(V_Core& thiscore, uint voiceidx)
 	vc.SCurrent += 4 - (vc.SCurrent & 3);
 }
 
+// --------------------------------------------------------------------------------------
+//  Silent voice fast path
+// --------------------------------------------------------------------------------------
+// A stopped voice still walks NextA forward a word at a time, to keep IRQ timing right.
+// Almost all of those steps are just NextA++. The number of steps until one that does more
+// (reaching the end of the block, or landing on IRQA of a core with IRQs enabled) follows
+// directly from NextA, SCurrent and the IRQ addresses. So it's worked out once, counted
+// down with plain increments, and only the step that hits the event goes through
+// GetNextDataDummy.
+//
+// NextA has to be current at every tick, since the game can read NAX at any time, so this
+// doesn't jump over ticks. It just makes each of them trivial. The step count is thrown
+// away whenever the IRQ setup changes, or the voice's address is changed from outside
+// (key on, NAX writes).
+
+struct SilentVoiceState
+{
+	u32 Steps; ///< Plain steps left before the next event.
+	u32 NextA; ///< Where the last step left the voice.
+	u32 SCurrent;
+};
+
+static SilentVoiceState s_silent_voices[2][V_Core::NumVoices];
+static u32 s_silent_irq_generation = 0;
+static bool s_silent_fast_path = true;
+
+void OESndOut::SetSilentVoiceFastPath(bool enabled)
+{
+	s_silent_fast_path = enabled;
+	std::memset(s_silent_voices, 0, sizeof(s_silent_voices));
+}
+
+bool OESndOut::GetSilentVoiceFastPath()
+{
+	return s_silent_fast_path;
+}
+
+static void CheckSilentVoiceIrqSetup()
+{
+	if (s_silent_irq_generation == s_irq_watch.Generation)
+		return;
+
+	s_silent_irq_generation = s_irq_watch.Generation;
+	for (auto& core : s_silent_voices)
+		for (SilentVoiceState& state : core)
+			state.Steps = 0;
+}
+
+static u32 GetSilentVoiceSteps(const V_Voice& vc)
+{
+	// Steps start word-aligned after the first one. The step taken at SCurrent 28 loads the
+	// next block header.
+	if ((vc.SCurrent & 3) != 0 || vc.SCurrent >= 28)
+		return 0;
+
+	u32 steps = (28 - vc.SCurrent) / 4;
+
+	// Step k checks NextA + k - 1 against IRQA, then leaves NextA at NextA + k, where the
+	// loop end check fires if it's block aligned.
+	steps = std::min<u32>(steps, 7 - (vc.NextA & 7));
+	return std::min(steps, GetIrqDistance(vc.NextA));
+}
+
+static __forceinline void AdvanceSilentVoice(V_Core& thiscore, uint voiceidx)
+{
+	V_Voice& vc(thiscore.Voices[voiceidx]);
+	if (!s_silent_fast_path)
+	{
+		while (vc.SP >= 0)
+			GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
+		return;
+	}
+
+	SilentVoiceState& state = s_silent_voices[thiscore.Index][voiceidx];
+	if (state.NextA != vc.NextA || state.SCurrent != vc.SCurrent)
+		state.Steps = 0;
+
+	while (vc.SP >= 0)
+	{
+		if (state.Steps == 0)
+		{
+			GetNextDataDummy(thiscore, voiceidx);
+			state.Steps = GetSilentVoiceSteps(vc);
+			continue;
+		}
+
+		// Same as GetNextDataDummy when no IRQ, loop end or header load is due.
+		vc.NextA = (vc.NextA + 1) & 0xFFFFF;
+		vc.SP -= 0x4000;
+		vc.SCurrent += 4;
+		state.Steps--;
+	}
+
+	state.NextA = vc.NextA;
+	state.SCurrent = vc.SCurrent;
+}
+
+// --------------------------------------------------------------------------------------
+//  Batched ADPCM decoding
+// --------------------------------------------------------------------------------------
+// The prev1/prev2 predictor makes each block a serial chain of 28 samples, but blocks for
+// different voices don't depend on each other. XA_decode_blocks lays a batch of blocks out
+// one per lane and steps all of them through the chain together, so every step is the same
+// few integer ops across up to 48 lanes, which the compiler vectorizes.
+//
+// Before each mix tick, PredecodeVoiceBlocks works out which voices will start a new block
+// during the tick, and decodes those blocks into the decode cache in one batch. The fetch in
+// GetNextDataBuffered then finds them in the cache, and counts them as predecoded rather
+// than as hits, since the decode was only moved, not saved. The cache
+// checks the source bytes on every hit and always holds exactly what XA_decode_block would
+// produce, so output doesn't change.
+
+struct ADPCMBatch
+{
+	static constexpr uint MaxBlocks = 2 * V_Core::NumVoices;
+
+	uint Count = 0;
+	const s16* Blocks[MaxBlocks];
+	s16* Output[MaxBlocks];
+	alignas(32) s32 Shift[MaxBlocks];
+	alignas(32) s32 Pred1[MaxBlocks];
+	alignas(32) s32 Pred2[MaxBlocks];
+	alignas(32) s32 Prev1[MaxBlocks];
+	alignas(32) s32 Prev2[MaxBlocks];
+	alignas(32) s32 Data[pcm_DecodedSamplesPerBlock][MaxBlocks];
+	alignas(32) s32 Samples[pcm_DecodedSamplesPerBlock][MaxBlocks];
+
+	void Add(const s16* block, s16* output, s32 prev1, s32 prev2)
+	{
+		Blocks[Count] = block;
+		Output[Count] = output;
+		Prev1[Count] = prev1;
+		Prev2[Count] = prev2;
+		Count++;
+	}
+};
+
+static void XA_decode_blocks(ADPCMBatch& batch)
+{
+	const uint count = batch.Count;
+
+	// Unpack headers and nibbles into lanes.
+	for (uint lane = 0; lane < count; lane++)
+	{
+		const s16* block = batch.Blocks[lane];
+		const s32 header = *block;
+		const int id = header >> 4 & 0xF;
+		if (id > 4 && SPU2::MsgToConsole())
+			SPU2::ConLog("* SPU2: Unknown ADPCM coefficients table id %d\n", id);
+
+		batch.Shift[lane] = (header & 0xF) + 16;
+		batch.Pred1[lane] = tbl_XA_Factor[id][0];
+		batch.Pred2[lane] = tbl_XA_Factor[id][1];
+
+		const s8* blockbytes = (s8*)&block[1];
+		for (uint i = 0; i < pcm_DecodedSamplesPerBlock / 2; i++)
+		{
+			batch.Data[i * 2][lane] = (blockbytes[i] << 28) & 0xF0000000;
+			batch.Data[i * 2 + 1][lane] = (blockbytes[i] << 24) & 0xF0000000;
+		}
+	}
+
+	// Step every lane through the predictor together.
+	for (uint i = 0; i < pcm_DecodedSamplesPerBlock; i++)
+	{
+		const s32* data = batch.Data[i];
+		s32* samples = batch.Samples[i];
+		for (uint lane = 0; lane < count; lane++)
+		{
+			s32 pcm = (data[lane] >> batch.Shift[lane]) +
+					  (((batch.Pred1[lane] * batch.Prev1[lane]) + (batch.Pred2[lane] * batch.Prev2[lane]) + 32) >> 6);
+			pcm = std::clamp<s32>(pcm, -0x8000, 0x7fff);
+			samples[lane] = pcm;
+			batch.Prev2[lane] = batch.Prev1[lane];
+			batch.Prev1[lane] = pcm;
+		}
+	}
+
+	for (uint lane = 0; lane < count; lane++)
+	{
+		s16* output = batch.Output[lane];
+		for (uint i = 0; i < pcm_DecodedSamplesPerBlock; i++)
+			output[i] = static_cast<s16>(batch.Samples[i][lane]);
+	}
+}
+
+static void PredecodeVoiceBlocks()
+{
+	static ADPCMBatch batch;
+	DecodeCacheWay* ways[ADPCMBatch::MaxBlocks];
+	u32 blocks[ADPCMBatch::MaxBlocks];
+	s32 prevs[ADPCMBatch::MaxBlocks][2];
+	s16 samples[ADPCMBatch::MaxBlocks][pcm_DecodedSamplesPerBlock];
+	batch.Count = 0;
+
+	for (uint coreidx = 0; coreidx < 2; coreidx++)
+	{
+		V_Core& thiscore(Cores[coreidx]);
+		for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; voiceidx++)
+		{
+			const V_Voice& vc(thiscore.Voices[voiceidx]);
+
+			// Modulated pitch isn't known until the previous voice is mixed.
+			if (vc.ADSR.Phase <= V_ADSR::PHASE_STOPPED || vc.Noise || (vc.Modulated && voiceidx != 0))
+				continue;
+
+			// Same fetch count as the GetVoiceValues loop after UpdatePitch.
+			const s32 sp = vc.SP + std::min<s32>(vc.Pitch, 0x3FFF);
+			if (sp < 0)
+				continue;
+
+			const s32 fetches = (sp >> 12) + 1;
+			if (fetches <= 28 - static_cast<s32>(vc.SCurrent))
+				continue;
+
+			// Replay the NextA stepping of GetNextDataBuffered up to the fetch that loads the block.
+			u32 nexta = vc.NextA;
+			for (u32 scurrent = vc.SCurrent; scurrent <= 28; scurrent++)
+			{
+				if ((scurrent & 3) != 0)
+					continue;
+
+				nexta = (nexta + 1) & 0xFFFFF;
+				if ((nexta & 7) == 0)
+					nexta = (vc.LoopFlags & XAFLAG_LOOP_END) ? (vc.LoopStartA | 1) : (nexta + 1);
+			}
+
+			// Allocates the way on a miss, so a second voice after the same block is a hit.
+			DecodeCacheResult result;
+			const u32 block = nexta / pcm_WordsPerBlock;
+			const s16* memptr = GetMemPtr(nexta & 0xFFFF8);
+			DecodeCacheWay* way = DecodeCacheFind(coreidx, block, memptr, vc.Prev1, vc.Prev2, &result);
+			if (result == DecodeCacheResult::Hit)
+				continue;
+
+			ways[batch.Count] = way;
+			blocks[batch.Count] = block;
+			prevs[batch.Count][0] = vc.Prev1;
+			prevs[batch.Count][1] = vc.Prev2;
+			batch.Add(memptr, samples[batch.Count], vc.Prev1, vc.Prev2);
+		}
+	}
+
+	if (batch.Count == 0)
+		return;
+
+	XA_decode_blocks(batch);
+
+	// A set with more misses than ways can hand out the same way twice, the later
+	// block wins, and the earlier one just misses again when its voice gets to it.
+	for (uint lane = 0; lane < batch.Count; lane++)
+	{
+		DecodeCacheWay& way = *ways[lane];
+		if (way.Block == blocks[lane] + 1 && way.Prev1 == prevs[lane][0] && way.Prev2 == prevs[lane][1])
+		{
+			std::memcpy(way.Samples, samples[lane], sizeof(way.Samples));
+			way.Predecoded = true;
+		}
+	}
+}
+
+bool OESndOut::TestADPCMDecoder(u32 iterations, u32 seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> sample_dist(-0x8000, 0x7fff);
+	std::uniform_int_distribution<uint> count_dist(1, ADPCMBatch::MaxBlocks);
+
+	static ADPCMBatch batch;
+	s16 blocks[ADPCMBatch::MaxBlocks][pcm_WordsPerBlock];
+	s16 expected[ADPCMBatch::MaxBlocks][pcm_DecodedSamplesPerBlock];
+	s16 actual[ADPCMBatch::MaxBlocks][pcm_DecodedSamplesPerBlock];
+	s32 expected_prev[ADPCMBatch::MaxBlocks][2];
+
+	for (u32 iter = 0; iter < iterations; iter++)
+	{
+		batch.Count = 0;
+		const uint count = count_dist(rng);
+		for (uint lane = 0; lane < count; lane++)
+		{
+			for (s16& word : blocks[lane])
+				word = static_cast<s16>(sample_dist(rng));
+
+			s32 prev1 = sample_dist(rng);
+			s32 prev2 = sample_dist(rng);
+			batch.Add(blocks[lane], actual[lane], prev1, prev2);
+
+			XA_decode_block(expected[lane], blocks[lane], prev1, prev2);
+			expected_prev[lane][0] = prev1;
+			expected_prev[lane][1] = prev2;
+		}
+
+		XA_decode_blocks(batch);
+
+		for (uint lane = 0; lane < count; lane++)
+		{
+			if (std::memcmp(expected[lane], actual[lane], sizeof(expected[lane])) != 0 ||
+				batch.Prev1[lane] != expected_prev[lane][0] || batch.Prev2[lane] != expected_prev[lane][1])
+			{
+				Console.Error("(OESndOut) ADPCM batch decode mismatch: iteration %u, lane %u, header %04x",
+					iter, lane, static_cast<u16>(blocks[lane][0]));
+				return false;
+			}
+		}
+	}
+
+	Console.WriteLn("(OESndOut) ADPCM batch decoder matched the scalar decoder over %u batches.", iterations);
+	return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////
 /////////////////////////////////////////////////////////////////////////////////////////
 //                                                                                     //
@@ -290,6 +776,57 @@ __forceinline static s32 GaussianInterpolate(s32 pv4, s32 pv3, s32 pv2, s32 pv1,
 	return out;
 }
 
+// The SPU2's own 4-tap gaussian is the default. A Catmull-Rom cubic through the same four
+// samples is there for those who prefer a brighter sound over accuracy. Its taps are in
+// the same Q15 format and order as interpTable, so both go through the same kernels.
+// Weights of exactly 1.0 can't be represented and are stored as 0x7FFF.
+
+using InterpolationTable = std::array<std::array<s16, 4>, 256>;
+
+static constexpr InterpolationTable s_cubic_table = []() {
+	const auto to_q15 = [](double x) {
+		const s32 value = static_cast<s32>(x * 32768.0 + ((x >= 0.0) ? 0.5 : -0.5));
+		return static_cast<s16>(std::clamp<s32>(value, -0x8000, 0x7FFF));
+	};
+
+	InterpolationTable table = {};
+	for (u32 i = 0; i < 256; i++)
+	{
+		const double t = i / 256.0, t2 = t * t, t3 = t2 * t;
+		table[i][0] = to_q15((-t3 + 2.0 * t2 - t) * 0.5);
+		table[i][1] = to_q15((3.0 * t3 - 5.0 * t2 + 2.0) * 0.5);
+		table[i][2] = to_q15((-3.0 * t3 + 4.0 * t2 + t) * 0.5);
+		table[i][3] = to_q15((t3 - t2) * 0.5);
+	}
+	return table;
+}();
+
+static OESndOut::Interpolation s_interpolation = OESndOut::Interpolation::Gaussian;
+
+void OESndOut::SetInterpolation(Interpolation mode)
+{
+	s_interpolation = mode;
+}
+
+__forceinline static s32 CubicInterpolate(s32 pv4, s32 pv3, s32 pv2, s32 pv1, s32 i)
+{
+	s32 out = 0;
+	out =  (s_cubic_table[i][0] * pv4) >> 15;
+	out += (s_cubic_table[i][1] * pv3) >> 15;
+	out += (s_cubic_table[i][2] * pv2) >> 15;
+	out += (s_cubic_table[i][3] * pv1) >> 15;
+
+	return out;
+}
+
+__forceinline static s32 InterpolateVoice(s32 pv4, s32 pv3, s32 pv2, s32 pv1, s32 i)
+{
+	if (s_interpolation == OESndOut::Interpolation::Cubic)
+		return CubicInterpolate(pv4, pv3, pv2, pv1, i);
+
+	return GaussianInterpolate(pv4, pv3, pv2, pv1, i);
+}
+
 static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
 {
 	V_Voice& vc(thiscore.Voices[voiceidx]);
@@ -305,7 +842,7 @@ static __forceinline s32 GetVoiceValues(V_Core& thiscore, uint voiceidx)
 
 	const s32 mu = vc.SP + 0x1000;
 
-	return GaussianInterpolate(vc.PV4, vc.PV3, vc.PV2, vc.PV1, (mu & 0x0ff0) >> 4);
+	return InterpolateVoice(vc.PV4, vc.PV3, vc.PV2, vc.PV1, (mu & 0x0ff0) >> 4);
 }
 
 // This is Dr. Hell's noise algorithm as implemented in pcsxr
@@ -362,14 +899,7 @@ static __forceinline s32 GetNoiseValues(V_Core& thiscore)
 static __forceinline void spu2M_WriteFast(u32 addr, s16 value)
 {
 	// Fixes some of the oldest hangs in pcsx2's history! :p
-	for (int i = 0; i < 2; i++)
-	{
-		if (Cores[i].IRQEnable && Cores[i].IRQA == addr)
-		{
-			//printf("Core %d special write IRQ Called (IRQ passed). IRQA = %x\n",i,addr);
-			SetIrqCall(i);
-		}
-	}
+	CheckIrqWatch(addr);
 // throw an assertion if the memory range is invalid:
 #ifndef DEBUG_FAST
 	pxAssume(addr < SPU2_DYN_MEMLINE);
@@ -422,8 +952,7 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 	}
 	else
 	{
-		while (vc.SP >= 0)
-			GetNextDataDummy(thiscore, voiceidx); // Dummy is enough
+		AdvanceSilentVoice(thiscore, voiceidx);
 	}
 
 	// Write-back of raw voice data (post ADSR applied)
@@ -437,7 +966,7 @@ static __forceinline StereoOut32 MixVoice(uint coreidx, uint voiceidx)
 
 const VoiceMixSet VoiceMixSet::Empty((StereoOut32()), (StereoOut32())); // Don't use SteroOut32::Empty because C++ doesn't make any dep/order checks on global initializers.
 
-static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+static __forceinline void MixCoreVoicesScalar(VoiceMixSet& dest, const uint coreidx)
 {
 	V_Core& thiscore(Cores[coreidx]);
 
@@ -454,6 +983,655 @@ static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
 	}
 }
 
+// --------------------------------------------------------------------------------------
+//  Structure-of-arrays voice mixer
+// --------------------------------------------------------------------------------------
+// Splits MixVoice in two. The first pass walks the voices in order and does everything that
+// touches SPU2 state or has to happen in voice order: volume slides, pitch, fetching and
+// decoding samples (with their IRQs), ADSR. It leaves the interpolation inputs, envelope
+// and volumes for each voice in the arrays below. The second pass does the interpolation,
+// envelope, volume and gating for all 24 voices at once, as straight-line loops over those
+// arrays that the compiler turns into SSE4/AVX2 or NEON code.
+//
+// The few voices whose output is needed before the rest of the voices are fetched (1 and 3
+// are written back to SPU2 RAM, and any voice that the next one pitch-modulates off) are
+// finished in the first pass, exactly as MixVoice would. Only the order of the operations
+// changes, so the output is bit-identical to MixCoreVoicesScalar.
+
+struct alignas(32) VoiceMixLanes
+{
+	// Interpolation taps are kept at 16 bits, see InterpolateLanes.
+	s16 Coef[4][V_Core::NumVoices];
+	s16 PV[4][V_Core::NumVoices];
+	s32 Envelope[V_Core::NumVoices];
+	s32 Finished[V_Core::NumVoices]; ///< Output of voices already mixed in the first pass.
+	s32 VolL[V_Core::NumVoices];
+	s32 VolR[V_Core::NumVoices];
+	s32 GateDryL[V_Core::NumVoices];
+	s32 GateDryR[V_Core::NumVoices];
+	s32 GateWetL[V_Core::NumVoices];
+	s32 GateWetR[V_Core::NumVoices];
+	s32 Value[V_Core::NumVoices];
+};
+
+static bool s_soa_mixer = true;
+
+void OESndOut::SetSoAMixer(bool enabled)
+{
+	s_soa_mixer = enabled;
+}
+
+bool OESndOut::GetSoAMixer()
+{
+	return s_soa_mixer;
+}
+
+// Interpolation for all voices at once: out[v] = sum of (Coef[tap][v] * PV[tap][v]) >> 15.
+// Taps and samples both fit in 16 bits, so eight voices go in a register. The low and high
+// halves of each 32-bit product (pmullw/pmulhw, or NEON's widening multiply) are put back
+// together before the shift, which keeps the per-tap truncation of GaussianInterpolate.
+// Multiplying 32-bit lanes instead, which is what the compiler does with the plain loop,
+// is much slower on most x86 chips.
+
+static_assert(V_Core::NumVoices % 8 == 0);
+
+static __forceinline void InterpolateLanes(const s16 (&coef)[4][V_Core::NumVoices], const s16 (&pv)[4][V_Core::NumVoices], s32* out)
+{
+#if defined(_M_X86)
+	for (uint v = 0; v < V_Core::NumVoices; v += 8)
+	{
+		__m128i sum_lo = _mm_setzero_si128();
+		__m128i sum_hi = _mm_setzero_si128();
+		for (uint tap = 0; tap < 4; tap++)
+		{
+			const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&coef[tap][v]));
+			const __m128i p = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&pv[tap][v]));
+			const __m128i lo = _mm_mullo_epi16(c, p);
+			const __m128i hi = _mm_mulhi_epi16(c, p);
+			sum_lo = _mm_add_epi32(sum_lo, _mm_srai_epi32(_mm_unpacklo_epi16(lo, hi), 15));
+			sum_hi = _mm_add_epi32(sum_hi, _mm_srai_epi32(_mm_unpackhi_epi16(lo, hi), 15));
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&out[v]), sum_lo);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(&out[v + 4]), sum_hi);
+	}
+#elif defined(_M_ARM64)
+	for (uint v = 0; v < V_Core::NumVoices; v += 8)
+	{
+		int32x4_t sum_lo = vdupq_n_s32(0);
+		int32x4_t sum_hi = vdupq_n_s32(0);
+		for (uint tap = 0; tap < 4; tap++)
+		{
+			const int16x8_t c = vld1q_s16(&coef[tap][v]);
+			const int16x8_t p = vld1q_s16(&pv[tap][v]);
+			sum_lo = vaddq_s32(sum_lo, vshrq_n_s32(vmull_s16(vget_low_s16(c), vget_low_s16(p)), 15));
+			sum_hi = vaddq_s32(sum_hi, vshrq_n_s32(vmull_high_s16(c, p), 15));
+		}
+		vst1q_s32(&out[v], sum_lo);
+		vst1q_s32(&out[v + 4], sum_hi);
+	}
+#else
+	for (uint v = 0; v < V_Core::NumVoices; v++)
+	{
+		s32 sum = (coef[0][v] * pv[0][v]) >> 15;
+		sum += (coef[1][v] * pv[1][v]) >> 15;
+		sum += (coef[2][v] * pv[2][v]) >> 15;
+		sum += (coef[3][v] * pv[3][v]) >> 15;
+		out[v] = sum;
+	}
+#endif
+}
+
+static __forceinline void FetchVoiceLane(VoiceMixLanes& lanes, V_Core& thiscore, uint coreidx, uint voiceidx, u32* deferred, uint& num_deferred)
+{
+	V_Voice& vc(thiscore.Voices[voiceidx]);
+
+	pxAssertMsg((vc.SCurrent <= 28) && (vc.SCurrent != 0), "Current sample should always range from 1->28");
+
+	vc.Volume.Update();
+	UpdatePitch(coreidx, voiceidx);
+
+	for (uint i = 0; i < 4; i++)
+	{
+		lanes.Coef[i][voiceidx] = 0;
+		lanes.PV[i][voiceidx] = 0;
+	}
+	lanes.Envelope[voiceidx] = 0;
+	lanes.Finished[voiceidx] = 0;
+	lanes.VolL[voiceidx] = vc.Volume.Left.Value;
+	lanes.VolR[voiceidx] = vc.Volume.Right.Value;
+	lanes.GateDryL[voiceidx] = thiscore.VoiceGates[voiceidx].DryL;
+	lanes.GateDryR[voiceidx] = thiscore.VoiceGates[voiceidx].DryR;
+	lanes.GateWetL[voiceidx] = thiscore.VoiceGates[voiceidx].WetL;
+	lanes.GateWetR[voiceidx] = thiscore.VoiceGates[voiceidx].WetR;
+
+	s32 Value = 0;
+
+	if (vc.ADSR.Phase > V_ADSR::PHASE_STOPPED)
+	{
+		const bool needed_now = (voiceidx == 1 || voiceidx == 3 ||
+								 (voiceidx + 1 < V_Core::NumVoices && thiscore.Voices[voiceidx + 1].Modulated));
+
+		if (vc.Noise)
+		{
+			Value = GetNoiseValues(thiscore);
+		}
+		else
+		{
+			while (vc.SP >= 0)
+			{
+				vc.PV4 = vc.PV3;
+				vc.PV3 = vc.PV2;
+				vc.PV2 = vc.PV1;
+				vc.PV1 = GetNextDataBuffered(thiscore, voiceidx);
+				vc.SP -= 0x1000;
+			}
+
+			const s32 mu = vc.SP + 0x1000;
+			const uint i = (mu & 0x0ff0) >> 4;
+			if (needed_now)
+			{
+				Value = InterpolateVoice(vc.PV4, vc.PV3, vc.PV2, vc.PV1, i);
+			}
+			else
+			{
+				for (uint tap = 0; tap < 4; tap++)
+				{
+					lanes.Coef[tap][voiceidx] = (s_interpolation == OESndOut::Interpolation::Cubic) ?
+													s_cubic_table[i][tap] :
+													static_cast<s16>(interpTable[i][tap]);
+				}
+				lanes.PV[0][voiceidx] = static_cast<s16>(vc.PV4);
+				lanes.PV[1][voiceidx] = static_cast<s16>(vc.PV3);
+				lanes.PV[2][voiceidx] = static_cast<s16>(vc.PV2);
+				lanes.PV[3][voiceidx] = static_cast<s16>(vc.PV1);
+			}
+		}
+
+		CalculateADSR(thiscore, voiceidx);
+
+		if (needed_now || vc.Noise)
+		{
+			Value = ApplyVolume(Value, vc.ADSR.Value);
+			vc.OutX = Value;
+			lanes.Finished[voiceidx] = Value;
+
+			if (IsDevBuild)
+				DebugCores[coreidx].Voices[voiceidx].displayPeak = std::max(DebugCores[coreidx].Voices[voiceidx].displayPeak, (s32)vc.OutX);
+		}
+		else
+		{
+			lanes.Envelope[voiceidx] = vc.ADSR.Value;
+			deferred[num_deferred++] = voiceidx;
+		}
+	}
+	else
+	{
+		AdvanceSilentVoice(thiscore, voiceidx);
+	}
+
+	// Write-back of raw voice data (post ADSR applied)
+	if (voiceidx == 1)
+		spu2M_WriteFast(((0 == coreidx) ? 0x400 : 0xc00) + OutPos, Value);
+	else if (voiceidx == 3)
+		spu2M_WriteFast(((0 == coreidx) ? 0x600 : 0xe00) + OutPos, Value);
+}
+
+static __forceinline void MixCoreVoicesSoA(VoiceMixSet& dest, const uint coreidx)
+{
+	V_Core& thiscore(Cores[coreidx]);
+	VoiceMixLanes lanes;
+	u32 deferred[V_Core::NumVoices];
+	uint num_deferred = 0;
+
+	for (uint voiceidx = 0; voiceidx < V_Core::NumVoices; ++voiceidx)
+		FetchVoiceLane(lanes, thiscore, coreidx, voiceidx, deferred, num_deferred);
+
+	// Lanes finished in the first pass have zero coefficients and envelope here, so they
+	// only pick up their Finished value, and vice versa.
+	InterpolateLanes(lanes.Coef, lanes.PV, lanes.Value);
+	for (uint v = 0; v < V_Core::NumVoices; v++)
+		lanes.Value[v] = ((lanes.Value[v] * lanes.Envelope[v]) >> 15) + lanes.Finished[v];
+
+	s32 DryL = 0, DryR = 0, WetL = 0, WetR = 0;
+	for (uint v = 0; v < V_Core::NumVoices; v++)
+	{
+		const s32 L = (lanes.VolL[v] * lanes.Value[v]) >> 15;
+		const s32 R = (lanes.VolR[v] * lanes.Value[v]) >> 15;
+		DryL += L & lanes.GateDryL[v];
+		DryR += R & lanes.GateDryR[v];
+		WetL += L & lanes.GateWetL[v];
+		WetR += R & lanes.GateWetR[v];
+	}
+
+	dest.Dry.Left += DryL;
+	dest.Dry.Right += DryR;
+	dest.Wet.Left += WetL;
+	dest.Wet.Right += WetR;
+
+	for (uint i = 0; i < num_deferred; i++)
+	{
+		const u32 v = deferred[i];
+		thiscore.Voices[v].OutX = lanes.Value[v];
+
+		if (IsDevBuild)
+			DebugCores[coreidx].Voices[v].displayPeak = std::max(DebugCores[coreidx].Voices[v].displayPeak, (s32)lanes.Value[v]);
+	}
+}
+
+bool OESndOut::TestInterpolation(u32 iterations, u32 seed)
+{
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> sample_dist(-0x8000, 0x7fff);
+
+	alignas(16) s16 coef[4][V_Core::NumVoices];
+	alignas(16) s16 pv[4][V_Core::NumVoices];
+	s32 actual[V_Core::NumVoices];
+
+	for (u32 iter = 0; iter < iterations; iter++)
+	{
+		// Every other round uses the cubic table, as its taps can reach 0x7FFF.
+		const bool cubic = (iter & 1) != 0;
+		u32 phase[V_Core::NumVoices];
+		for (uint v = 0; v < V_Core::NumVoices; v++)
+		{
+			phase[v] = rng() & 0xFF;
+			for (uint tap = 0; tap < 4; tap++)
+			{
+				coef[tap][v] = cubic ? s_cubic_table[phase[v]][tap] : static_cast<s16>(interpTable[phase[v]][tap]);
+				pv[tap][v] = static_cast<s16>(sample_dist(rng));
+			}
+		}
+
+		InterpolateLanes(coef, pv, actual);
+
+		for (uint v = 0; v < V_Core::NumVoices; v++)
+		{
+			const s32 expected = cubic ? CubicInterpolate(pv[0][v], pv[1][v], pv[2][v], pv[3][v], phase[v]) :
+										 GaussianInterpolate(pv[0][v], pv[1][v], pv[2][v], pv[3][v], phase[v]);
+			if (actual[v] != expected)
+			{
+				Console.Error("(OESndOut) Interpolation mismatch: iteration %u, voice %u, phase %u, %d != %d",
+					iter, v, phase[v], actual[v], expected);
+				return false;
+			}
+		}
+	}
+
+	Console.WriteLn("(OESndOut) Interpolation kernel matched the scalar interpolators over %u iterations.", iterations);
+	return true;
+}
+
+void OESndOut::BenchmarkInterpolation(u32 iterations)
+{
+	// A handful of different inputs, so the scalar loop can't be hoisted out.
+	static constexpr u32 NumInputs = 16;
+
+	std::mt19937 rng(0);
+	std::uniform_int_distribution<int> sample_dist(-0x8000, 0x7fff);
+
+	alignas(16) static s16 coef[NumInputs][4][V_Core::NumVoices];
+	alignas(16) static s16 pv[NumInputs][4][V_Core::NumVoices];
+	static u32 phase[NumInputs][V_Core::NumVoices];
+	s32 out[V_Core::NumVoices];
+
+	for (u32 n = 0; n < NumInputs; n++)
+	{
+		for (uint v = 0; v < V_Core::NumVoices; v++)
+		{
+			phase[n][v] = rng() & 0xFF;
+			for (uint tap = 0; tap < 4; tap++)
+			{
+				coef[n][tap][v] = static_cast<s16>(interpTable[phase[n][v]][tap]);
+				pv[n][tap][v] = static_cast<s16>(sample_dist(rng));
+			}
+		}
+	}
+
+	s32 checksum = 0;
+	Common::Timer timer;
+	for (u32 iter = 0; iter < iterations; iter++)
+	{
+		const u32 n = iter % NumInputs;
+		for (uint v = 0; v < V_Core::NumVoices; v++)
+			out[v] = GaussianInterpolate(pv[n][0][v], pv[n][1][v], pv[n][2][v], pv[n][3][v], phase[n][v]);
+		checksum += out[iter % V_Core::NumVoices];
+	}
+	const double scalar_seconds = timer.GetTimeSecondsAndReset();
+
+	for (u32 iter = 0; iter < iterations; iter++)
+	{
+		const u32 n = iter % NumInputs;
+		InterpolateLanes(coef[n], pv[n], out);
+		checksum -= out[iter % V_Core::NumVoices];
+	}
+	const double kernel_seconds = timer.GetTimeSeconds();
+
+	const double voices = static_cast<double>(iterations) * V_Core::NumVoices;
+	Console.WriteLn("(OESndOut) Interpolation: scalar %.2f ns, kernel %.2f ns per voice-sample (%.2fx)%s",
+		scalar_seconds * 1e9 / voices, kernel_seconds * 1e9 / voices,
+		(kernel_seconds > 0.0) ? (scalar_seconds / kernel_seconds) : 0.0, (checksum != 0) ? ", results differ!" : "");
+}
+
+static __forceinline void MixCoreVoices(VoiceMixSet& dest, const uint coreidx)
+{
+	if (s_soa_mixer)
+		MixCoreVoicesSoA(dest, coreidx);
+	else
+		MixCoreVoicesScalar(dest, coreidx);
+}
+
+static void MixAllCoreVoices(VoiceMixSet* dest)
+{
+	MixCoreVoices(dest[0], 0);
+	MixCoreVoices(dest[1], 1);
+	FlushDecodeCacheCounts();
+}
+
+// --------------------------------------------------------------------------------------
+//  Reverb
+// --------------------------------------------------------------------------------------
+// Same algorithm as V_Core::DoReverb, which stays around as the reference. Each tick reads
+// and writes 14 reverb buffer addresses, all of the form (Cycles / 2 + offset) % size, and
+// those 14 divisions were most of the cost. The offsets only change on register writes, so
+// they are reduced modulo the buffer size once and cached per core. Per tick that leaves a
+// single division for the position, and every tap is an add plus a conditional subtract.
+//
+// The shortcut only holds while no offset takes the position below zero, which the
+// reference wraps at 2^32 rather than at the buffer size. That's only ever true for the
+// first few ticks after a reset, which take the exact path instead.
+
+enum ReverbTap : u32
+{
+	ReverbTap_SameSrc,
+	ReverbTap_SameDst,
+	ReverbTap_SamePrv,
+	ReverbTap_DiffSrc,
+	ReverbTap_DiffDst,
+	ReverbTap_DiffPrv,
+	ReverbTap_Comb1Src,
+	ReverbTap_Comb2Src,
+	ReverbTap_Comb3Src,
+	ReverbTap_Comb4Src,
+	ReverbTap_Apf1Src,
+	ReverbTap_Apf1Dst,
+	ReverbTap_Apf2Src,
+	ReverbTap_Apf2Dst,
+	ReverbTap_Count,
+};
+
+struct ReverbLayout
+{
+	// Register state the layout was built from.
+	u32 EffectsStartA;
+	u32 EffectsEndA;
+	u8 Regs[sizeof(V_Core::Revb)];
+	bool Valid;
+
+	u32 Start;
+	u32 Size;
+	u32 MinPosition; ///< Smallest Cycles / 2 the reduced offsets are valid for.
+	s32 Offset[2][ReverbTap_Count]; ///< As DoReverb passes them to the indexer, per channel.
+	u32 Reduced[2][ReverbTap_Count]; ///< Offset modulo Size.
+};
+
+static ReverbLayout s_reverb_layout[2];
+static bool s_fast_reverb = true;
+
+void OESndOut::SetFastReverb(bool enabled)
+{
+	s_fast_reverb = enabled;
+}
+
+bool OESndOut::GetFastReverb()
+{
+	return s_fast_reverb;
+}
+
+static void GetReverbOffsets(const V_Core& core, bool right, s32* offsets)
+{
+	const auto& revb = core.Revb;
+	offsets[ReverbTap_SameSrc] = right ? revb.SAME_R_SRC : revb.SAME_L_SRC;
+	offsets[ReverbTap_SameDst] = right ? revb.SAME_R_DST : revb.SAME_L_DST;
+	offsets[ReverbTap_SamePrv] = right ? revb.SAME_R_DST - 1 : revb.SAME_L_DST - 1;
+	offsets[ReverbTap_DiffSrc] = right ? revb.DIFF_L_SRC : revb.DIFF_R_SRC;
+	offsets[ReverbTap_DiffDst] = right ? revb.DIFF_R_DST : revb.DIFF_L_DST;
+	offsets[ReverbTap_DiffPrv] = right ? revb.DIFF_R_DST - 1 : revb.DIFF_L_DST - 1;
+	offsets[ReverbTap_Comb1Src] = right ? revb.COMB1_R_SRC : revb.COMB1_L_SRC;
+	offsets[ReverbTap_Comb2Src] = right ? revb.COMB2_R_SRC : revb.COMB2_L_SRC;
+	offsets[ReverbTap_Comb3Src] = right ? revb.COMB3_R_SRC : revb.COMB3_L_SRC;
+	offsets[ReverbTap_Comb4Src] = right ? revb.COMB4_R_SRC : revb.COMB4_L_SRC;
+	offsets[ReverbTap_Apf1Src] = right ? (revb.APF1_R_DST - revb.APF1_SIZE) : (revb.APF1_L_DST - revb.APF1_SIZE);
+	offsets[ReverbTap_Apf1Dst] = right ? revb.APF1_R_DST : revb.APF1_L_DST;
+	offsets[ReverbTap_Apf2Src] = right ? (revb.APF2_R_DST - revb.APF2_SIZE) : (revb.APF2_L_DST - revb.APF2_SIZE);
+	offsets[ReverbTap_Apf2Dst] = right ? revb.APF2_R_DST : revb.APF2_L_DST;
+}
+
+static void UpdateReverbLayout(const V_Core& core, ReverbLayout& layout)
+{
+	if (layout.Valid && layout.EffectsStartA == core.EffectsStartA && layout.EffectsEndA == core.EffectsEndA &&
+		std::memcmp(layout.Regs, &core.Revb, sizeof(layout.Regs)) == 0)
+	{
+		return;
+	}
+
+	layout.EffectsStartA = core.EffectsStartA;
+	layout.EffectsEndA = core.EffectsEndA;
+	std::memcpy(layout.Regs, &core.Revb, sizeof(layout.Regs));
+	layout.Valid = true;
+
+	const u32 end = (core.EffectsEndA & 0x3FFFFF) | 0xFFFF;
+	layout.Start = core.EffectsStartA & 0x3FFFFF;
+	layout.Size = end - layout.Start + 1;
+	layout.MinPosition = 0;
+	for (u32 right = 0; right < 2; right++)
+	{
+		GetReverbOffsets(core, right != 0, layout.Offset[right]);
+		for (u32 tap = 0; tap < ReverbTap_Count; tap++)
+		{
+			const s64 offset = layout.Offset[right][tap];
+			const s64 size = layout.Size;
+			layout.Reduced[right][tap] = static_cast<u32>(((offset % size) + size) % size);
+			if (offset < 0)
+				layout.MinPosition = std::max<u32>(layout.MinPosition, static_cast<u32>(-offset));
+		}
+	}
+}
+
+/// Exactly what V_Core::RevbGetIndexer computes.
+static __forceinline u32 GetReverbIndexExact(const ReverbLayout& layout, u32 pos, s32 offset)
+{
+	const u32 x = (pos + offset) % layout.Size;
+	return (x + layout.Start) & 0xFFFFF;
+}
+
+static StereoOut32 DoReverbFast(V_Core& core, const StereoOut32& Input)
+{
+	if (core.EffectsStartA >= core.EffectsEndA)
+		return StereoOut32::Empty;
+
+	core.RevbDownBuf[0][core.RevbSampleBufPos] = Input.Left;
+	core.RevbDownBuf[1][core.RevbSampleBufPos] = Input.Right;
+	core.RevbDownBuf[0][core.RevbSampleBufPos | 64] = Input.Left;
+	core.RevbDownBuf[1][core.RevbSampleBufPos | 64] = Input.Right;
+
+	const bool R = Cycles & 1;
+
+	ReverbLayout& layout = s_reverb_layout[core.Index];
+	UpdateReverbLayout(core, layout);
+
+	u32 addr[ReverbTap_Count];
+	const u32 pos = Cycles >> 1;
+	if (pos >= layout.MinPosition)
+	{
+		const u32 base = pos % layout.Size;
+		for (u32 tap = 0; tap < ReverbTap_Count; tap++)
+		{
+			u32 x = base + layout.Reduced[R][tap];
+			if (x >= layout.Size)
+				x -= layout.Size;
+			addr[tap] = (x + layout.Start) & 0xFFFFF;
+		}
+	}
+	else
+	{
+		for (u32 tap = 0; tap < ReverbTap_Count; tap++)
+			addr[tap] = GetReverbIndexExact(layout, pos, layout.Offset[R][tap]);
+	}
+
+	// Like DoReverb, IRQ addresses outside the effects area are never checked.
+	for (u32 i = 0; i < s_irq_watch.Count; i++)
+	{
+		const u32 irqa = s_irq_watch.Addr[i];
+		if (irqa < core.EffectsStartA || irqa > core.EffectsEndA)
+			continue;
+
+		for (u32 tap = 0; tap < ReverbTap_Count; tap++)
+		{
+			if (addr[tap] == irqa)
+			{
+				SetIrqCall(s_irq_watch.Core[i]);
+				break;
+			}
+		}
+	}
+
+	if (core.FxEnable)
+	{
+		const auto& revb = core.Revb;
+		const auto mul = [](s32 x, s32 y) { return (x * y) >> 15; };
+		const s32 in = mul(R ? revb.IN_COEF_R : revb.IN_COEF_L, ReverbDownsample(core, R));
+
+		const s32 same_prv = _spu2mem[addr[ReverbTap_SamePrv]];
+		const s32 diff_prv = _spu2mem[addr[ReverbTap_DiffPrv]];
+		const s32 same = mul(revb.IIR_VOL, in + mul(revb.WALL_VOL, _spu2mem[addr[ReverbTap_SameSrc]]) - same_prv) + same_prv;
+		const s32 diff = mul(revb.IIR_VOL, in + mul(revb.WALL_VOL, _spu2mem[addr[ReverbTap_DiffSrc]]) - diff_prv) + diff_prv;
+
+		s32 out = mul(revb.COMB1_VOL, _spu2mem[addr[ReverbTap_Comb1Src]]) + mul(revb.COMB2_VOL, _spu2mem[addr[ReverbTap_Comb2Src]]) +
+				  mul(revb.COMB3_VOL, _spu2mem[addr[ReverbTap_Comb3Src]]) + mul(revb.COMB4_VOL, _spu2mem[addr[ReverbTap_Comb4Src]]);
+
+		const s32 apf1_src = _spu2mem[addr[ReverbTap_Apf1Src]];
+		const s32 apf1 = out - mul(revb.APF1_VOL, apf1_src);
+		out = apf1_src + mul(revb.APF1_VOL, apf1);
+		const s32 apf2_src = _spu2mem[addr[ReverbTap_Apf2Src]];
+		const s32 apf2 = out - mul(revb.APF2_VOL, apf2_src);
+		out = apf2_src + mul(revb.APF2_VOL, apf2);
+
+		_spu2mem[addr[ReverbTap_SameDst]] = clamp_mix(same);
+		_spu2mem[addr[ReverbTap_DiffDst]] = clamp_mix(diff);
+		_spu2mem[addr[ReverbTap_Apf1Dst]] = clamp_mix(apf1);
+		_spu2mem[addr[ReverbTap_Apf2Dst]] = clamp_mix(apf2);
+
+		core.RevbUpBuf[R][core.RevbSampleBufPos] = clamp_mix(out);
+		core.RevbUpBuf[!R][core.RevbSampleBufPos] = 0;
+	}
+	else
+	{
+		core.RevbUpBuf[0][core.RevbSampleBufPos] = 0;
+		core.RevbUpBuf[1][core.RevbSampleBufPos] = 0;
+	}
+
+	core.RevbUpBuf[0][core.RevbSampleBufPos | 64] = core.RevbUpBuf[0][core.RevbSampleBufPos];
+	core.RevbUpBuf[1][core.RevbSampleBufPos | 64] = core.RevbUpBuf[1][core.RevbSampleBufPos];
+
+	core.RevbSampleBufPos = (core.RevbSampleBufPos + 1) & 63;
+
+	return ReverbUpsample(core);
+}
+
+bool OESndOut::TestReverb(u32 iterations, u32 seed)
+{
+	static constexpr u32 TicksPerIteration = 16;
+	static constexpr size_t MemorySize = 0x100000 * sizeof(s16);
+
+	std::mt19937 rng(seed);
+	std::uniform_int_distribution<int> sample_dist(-0x8000, 0x7fff);
+
+	// Runs on the live core 0 and SPU2 RAM, so keep them to put back afterwards.
+	V_Core& core = Cores[0];
+	std::vector<u8> saved_core(sizeof(V_Core));
+	std::vector<u8> saved_memory(MemorySize);
+	std::memcpy(saved_core.data(), &core, sizeof(V_Core));
+	std::memcpy(saved_memory.data(), _spu2mem, MemorySize);
+	const u32 saved_cycles = Cycles;
+	const bool saved_irq_enable[2] = {Cores[0].IRQEnable, Cores[1].IRQEnable};
+	const IrqWatch saved_irq_watch = s_irq_watch;
+
+	// IRQs are left out, they'd be raised on the live IOP.
+	Cores[0].IRQEnable = false;
+	Cores[1].IRQEnable = false;
+	s_irq_watch.Count = 0;
+
+	std::vector<u8> start_core(sizeof(V_Core));
+	std::vector<u8> start_memory(MemorySize);
+	std::vector<u8> expected_core(sizeof(V_Core));
+	std::vector<u8> expected_memory(MemorySize);
+	StereoOut32 input[TicksPerIteration];
+	StereoOut32 expected[TicksPerIteration];
+
+	bool result = true;
+	for (u32 iter = 0; iter < iterations && result; iter++)
+	{
+		// Random registers, including offsets that wrap below zero, and every so often a
+		// position at the very start so the exact path gets covered as well.
+		u8* regs = reinterpret_cast<u8*>(&core.Revb);
+		for (size_t i = 0; i < sizeof(core.Revb); i++)
+			regs[i] = static_cast<u8>(rng());
+		core.EffectsStartA = rng() & 0xFFFFF;
+		core.EffectsEndA = std::min<u32>(core.EffectsStartA + 1 + (rng() & 0x3FFFF), 0xFFFFF);
+		core.FxEnable = (rng() & 7) != 0;
+		core.RevbSampleBufPos = rng() & 63;
+		Cycles = (rng() & 3) ? rng() : (rng() & 0xFF);
+
+		for (s16* word = _spu2mem; word != _spu2mem + MemorySize / sizeof(s16); word++)
+			*word = static_cast<s16>(sample_dist(rng));
+		for (StereoOut32& in : input)
+			in = StereoOut32(sample_dist(rng), sample_dist(rng));
+
+		std::memcpy(start_core.data(), &core, sizeof(V_Core));
+		std::memcpy(start_memory.data(), _spu2mem, MemorySize);
+		const u32 start_cycles = Cycles;
+
+		for (u32 tick = 0; tick < TicksPerIteration; tick++, Cycles++)
+			expected[tick] = core.DoReverb(input[tick]);
+		std::memcpy(expected_core.data(), &core, sizeof(V_Core));
+		std::memcpy(expected_memory.data(), _spu2mem, MemorySize);
+
+		std::memcpy(&core, start_core.data(), sizeof(V_Core));
+		std::memcpy(_spu2mem, start_memory.data(), MemorySize);
+		Cycles = start_cycles;
+
+		for (u32 tick = 0; tick < TicksPerIteration; tick++, Cycles++)
+		{
+			const StereoOut32 actual = DoReverbFast(core, input[tick]);
+			if (actual.Left != expected[tick].Left || actual.Right != expected[tick].Right)
+			{
+				Console.Error("(OESndOut) Reverb output mismatch: iteration %u, tick %u", iter, tick);
+				result = false;
+				break;
+			}
+		}
+
+		if (result && (std::memcmp(expected_core.data(), &core, sizeof(V_Core)) != 0 ||
+						  std::memcmp(expected_memory.data(), _spu2mem, MemorySize) != 0))
+		{
+			Console.Error("(OESndOut) Reverb state mismatch: iteration %u", iter);
+			result = false;
+		}
+	}
+
+	std::memcpy(&core, saved_core.data(), sizeof(V_Core));
+	std::memcpy(_spu2mem, saved_memory.data(), MemorySize);
+	Cycles = saved_cycles;
+	Cores[0].IRQEnable = saved_irq_enable[0];
+	Cores[1].IRQEnable = saved_irq_enable[1];
+	s_irq_watch = saved_irq_watch;
+	s_reverb_layout[0].Valid = false;
+
+	if (result)
+		Console.WriteLn("(OESndOut) Fast reverb matched V_Core::DoReverb over %u iterations.", iterations);
+	return result;
+}
+
 StereoOut32 V_Core::Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, const StereoOut32& Ext)
 {
 	MasterVol.Update();
@@ -523,7 +1701,7 @@ StereoOut32 V_Core::Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, c
 	WaveDump::WriteCore(Index, CoreSrc_PreReverb, TW);
 #endif
 
-	StereoOut32 RV = DoReverb(TW);
+	StereoOut32 RV = s_fast_reverb ? DoReverbFast(*this, TW) : DoReverb(TW);
 
 #ifdef PCSX2_DEVBUILD
 	WaveDump::WriteCore(Index, CoreSrc_PostReverb, RV);
@@ -534,6 +1712,290 @@ StereoOut32 V_Core::Mix(const VoiceMixSet& inVoices, const StereoOut32& Input, c
 	return TD + ApplyVolume(RV, FxVol);
 }
 
+OESndOut::Statistics OESndOut::g_stats;
+
+// Mixed output is staged here and handed to the host one block at a time, rather than
+// paying for a host buffer write on every single 48khz sample.
+static s16 s_output_block[OESndOut::BlockFrames * 2];
+static uint s_output_block_pos = 0;
+static OESndOut::OutputSink s_output_sink = nullptr;
+static void* s_output_sink_userdata = nullptr;
+static OESndOut::TickObserver s_tick_observer = nullptr;
+static void* s_tick_observer_userdata = nullptr;
+
+// --------------------------------------------------------------------------------------
+//  Rate control
+// --------------------------------------------------------------------------------------
+// The host plays at exactly 48khz, but the EE never runs at exactly its nominal speed, so
+// left alone the host buffer slowly fills up (latency) or runs dry (crackle). Each block is
+// resampled by a ratio steered by how full the host buffer is, at most MaxRateDeviation
+// either way, which is small enough that the pitch change can't be heard. When the VM runs
+// at a different target speed (fast forward, slow motion) the difference is far too big for
+// that, so SoundTouch changes the tempo first, keeping the pitch, and the resampler only
+// trims what is left.
+// Blocks going to an output sink are left untouched, as offline renders want the raw mix.
+
+static_assert(std::is_same_v<soundtouch::SAMPLETYPE, float>, "SoundTouch must be built with float samples");
+
+static constexpr double MaxRateDeviation = 0.005;
+static constexpr double FillSmoothing = 0.05;
+static constexpr float StretchThreshold = 0.01f; ///< How far off 100% speed before stretching.
+
+struct RateControl
+{
+	bool Enabled = true;
+	OESndOut::Resampler Quality = OESndOut::Resampler::Cubic;
+
+	double Fill = -1.0; ///< Smoothed host buffer fill in frames, negative until the first block.
+	double Position = 1.0; ///< Read position in Input, in frames. Input[0] is history.
+	std::vector<float> Input; ///< Interleaved frames not yet consumed by the resampler.
+	std::vector<float> Stretched;
+	std::vector<s16> Output;
+
+	std::unique_ptr<soundtouch::SoundTouch> Stretcher;
+	float Tempo = 1.0f;
+};
+
+static RateControl s_rate;
+
+static void ResetRateControlState()
+{
+	s_rate.Fill = -1.0;
+	s_rate.Position = 1.0;
+	s_rate.Input.assign(2, 0.0f);
+	if (s_rate.Stretcher)
+		s_rate.Stretcher->clear();
+}
+
+/// Returns the output/input frame ratio to use for the next block.
+static double UpdateRateRatio()
+{
+	uint queued, capacity;
+	Host::GetSoundBufferLevel(&queued, &capacity);
+	if (capacity == 0)
+		return 1.0;
+
+	if (s_rate.Fill < 0.0)
+		s_rate.Fill = queued;
+	else
+		s_rate.Fill += (queued - s_rate.Fill) * FillSmoothing;
+
+	// Aim for half full, so there's as much room for the EE to run ahead as to fall behind.
+	const double target = capacity * 0.5;
+	const double error = std::clamp((s_rate.Fill - target) / target, -1.0, 1.0);
+	const double ratio = 1.0 - MaxRateDeviation * error;
+
+	OESndOut::g_stats.BufferedFrames.store(static_cast<u32>(s_rate.Fill), std::memory_order_relaxed);
+	OESndOut::g_stats.CorrectionPPM.store(static_cast<s32>((ratio - 1.0) * 1e6), std::memory_order_relaxed);
+	return ratio;
+}
+
+static float GetStretchTempo()
+{
+	// Zero when unlimited. There's no sensible tempo then, the host buffer just overflows.
+	const float speed = VMManager::GetTargetSpeed();
+	if (speed <= 0.0f || std::abs(speed - 1.0f) < StretchThreshold)
+		return 1.0f;
+
+	return speed;
+}
+
+static void UpdateStretcher(float tempo)
+{
+	if (tempo == s_rate.Tempo)
+		return;
+
+	if (!s_rate.Stretcher)
+	{
+		// PCSX2's default stretch parameters.
+		s_rate.Stretcher = std::make_unique<soundtouch::SoundTouch>();
+		s_rate.Stretcher->setSampleRate(48000);
+		s_rate.Stretcher->setChannels(2);
+		s_rate.Stretcher->setSetting(SETTING_USE_QUICKSEEK, 0);
+		s_rate.Stretcher->setSetting(SETTING_USE_AA_FILTER, 0);
+		s_rate.Stretcher->setSetting(SETTING_SEQUENCE_MS, 30);
+		s_rate.Stretcher->setSetting(SETTING_SEEKWINDOW_MS, 20);
+		s_rate.Stretcher->setSetting(SETTING_OVERLAP_MS, 10);
+	}
+
+	// Whatever is still inside the stretcher belongs to the old tempo. Dropping it is a tiny
+	// gap, at a moment where the sound changes speed anyway.
+	if (s_rate.Tempo == 1.0f || tempo == 1.0f)
+		s_rate.Stretcher->clear();
+
+	s_rate.Stretcher->setTempo(tempo);
+	s_rate.Tempo = tempo;
+	OESndOut::g_stats.StretchPercent.store(static_cast<u32>(tempo * 100.0f + 0.5f), std::memory_order_relaxed);
+}
+
+static __forceinline float InterpolateLinear(float p1, float p2, float t)
+{
+	return p1 + (p2 - p1) * t;
+}
+
+static __forceinline float InterpolateCubic(float p0, float p1, float p2, float p3, float t)
+{
+	// Catmull-Rom, passes through every input sample.
+	const float a = -0.5f * p0 + 1.5f * p1 - 1.5f * p2 + 0.5f * p3;
+	const float b = p0 - 2.5f * p1 + 2.0f * p2 - 0.5f * p3;
+	const float c = -0.5f * p0 + 0.5f * p2;
+	return ((a * t + b) * t + c) * t + p1;
+}
+
+static __forceinline s16 ToOutputSample(float value)
+{
+	return static_cast<s16>(std::clamp(value, -32768.0f, 32767.0f));
+}
+
+/// Appends \p frames to the resampler input and produces as many output frames as it can.
+static void Resample(const float* samples, uint frames, double ratio)
+{
+	s_rate.Input.insert(s_rate.Input.end(), samples, samples + frames * 2);
+
+	// Each output frame needs one frame before the read position and two after it.
+	const double step = 1.0 / ratio;
+	const float* in = s_rate.Input.data();
+	const size_t available = s_rate.Input.size() / 2;
+	double pos = s_rate.Position;
+	if (s_rate.Quality == OESndOut::Resampler::Cubic)
+	{
+		for (; static_cast<size_t>(pos) + 2 < available; pos += step)
+		{
+			const size_t i = static_cast<size_t>(pos);
+			const float t = static_cast<float>(pos - i);
+			const float* p = &in[(i - 1) * 2];
+			s_rate.Output.push_back(ToOutputSample(InterpolateCubic(p[0], p[2], p[4], p[6], t)));
+			s_rate.Output.push_back(ToOutputSample(InterpolateCubic(p[1], p[3], p[5], p[7], t)));
+		}
+	}
+	else
+	{
+		for (; static_cast<size_t>(pos) + 1 < available; pos += step)
+		{
+			const size_t i = static_cast<size_t>(pos);
+			const float t = static_cast<float>(pos - i);
+			const float* p = &in[i * 2];
+			s_rate.Output.push_back(ToOutputSample(InterpolateLinear(p[0], p[2], t)));
+			s_rate.Output.push_back(ToOutputSample(InterpolateLinear(p[1], p[3], t)));
+		}
+	}
+
+	// Keep one frame of history before the read position.
+	const size_t consumed = static_cast<size_t>(pos) - 1;
+	s_rate.Input.erase(s_rate.Input.begin(), s_rate.Input.begin() + consumed * 2);
+	s_rate.Position = pos - consumed;
+}
+
+static void WriteToHost(const s16* samples, uint frames)
+{
+	if (!s_rate.Enabled)
+	{
+		Host::WriteToSoundBuffer(samples, frames);
+		return;
+	}
+
+	if (s_rate.Input.empty())
+		ResetRateControlState();
+
+	float converted[OESndOut::BlockFrames * 2];
+	for (uint i = 0; i < frames * 2; i++)
+		converted[i] = samples[i];
+
+	const double ratio = UpdateRateRatio();
+	UpdateStretcher(GetStretchTempo());
+
+	s_rate.Output.clear();
+	if (s_rate.Tempo != 1.0f)
+	{
+		s_rate.Stretcher->putSamples(converted, frames);
+		s_rate.Stretched.resize(s_rate.Stretcher->numSamples() * 2);
+		const uint stretched = s_rate.Stretcher->receiveSamples(s_rate.Stretched.data(), s_rate.Stretcher->numSamples());
+		Resample(s_rate.Stretched.data(), stretched, ratio);
+	}
+	else
+	{
+		Resample(converted, frames, ratio);
+	}
+
+	if (!s_rate.Output.empty())
+		Host::WriteToSoundBuffer(s_rate.Output.data(), static_cast<uint>(s_rate.Output.size() / 2));
+}
+
+void OESndOut::SetRateControl(bool enabled)
+{
+	Flush();
+	s_rate.Enabled = enabled;
+	ResetRateControlState();
+}
+
+void OESndOut::ResetRateControl()
+{
+	ResetRateControlState();
+}
+
+void OESndOut::SetResampler(Resampler quality)
+{
+	s_rate.Quality = quality;
+}
+
+float OESndOut::GetLatencyMs()
+{
+	const u32 frames = g_stats.BufferedFrames.load(std::memory_order_relaxed) + s_output_block_pos;
+	return frames * 1000.0f / 48000.0f;
+}
+
+void OESndOut::Flush()
+{
+	if (s_output_block_pos == 0)
+		return;
+
+	if (s_output_sink)
+		s_output_sink(s_output_block, s_output_block_pos, s_output_sink_userdata);
+	else
+		WriteToHost(s_output_block, s_output_block_pos);
+
+	g_stats.FramesWritten.fetch_add(s_output_block_pos, std::memory_order_relaxed);
+	g_stats.BlocksWritten.fetch_add(1, std::memory_order_relaxed);
+	s_output_block_pos = 0;
+}
+
+void OESndOut::SetOutputSink(OutputSink sink, void* userdata)
+{
+	Flush();
+	s_output_sink = sink;
+	s_output_sink_userdata = userdata;
+}
+
+void OESndOut::SetTickObserver(TickObserver observer, void* userdata)
+{
+	s_tick_observer = observer;
+	s_tick_observer_userdata = userdata;
+}
+
+void OESndOut::ResetStatistics()
+{
+	g_stats.FramesWritten.store(0, std::memory_order_relaxed);
+	g_stats.BlocksWritten.store(0, std::memory_order_relaxed);
+	g_stats.Underruns.store(0, std::memory_order_relaxed);
+	g_stats.Overruns.store(0, std::memory_order_relaxed);
+	g_stats.CacheHits.store(0, std::memory_order_relaxed);
+	g_stats.CacheMisses.store(0, std::memory_order_relaxed);
+	g_stats.CacheStale.store(0, std::memory_order_relaxed);
+	g_stats.CachePredecoded.store(0, std::memory_order_relaxed);
+	g_stats.BufferedFrames.store(0, std::memory_order_relaxed);
+	g_stats.CorrectionPPM.store(0, std::memory_order_relaxed);
+}
+
+static __forceinline void WriteToOutputBlock(const StereoOut32& snd)
+{
+	//TODO: better truncation!
+	s_output_block[s_output_block_pos * 2] = static_cast<s16>(snd.Left);
+	s_output_block[s_output_block_pos * 2 + 1] = static_cast<s16>(snd.Right);
+
+	if (++s_output_block_pos == OESndOut::BlockFrames)
+		OESndOut::Flush();
+}
+
 static StereoOut32 DCFilter(StereoOut32 input) {
 	// A simple DC blocking high-pass filter
 	// Implementation from http://peabody.sapp.org/class/dmp2/lab/dcblock/
@@ -549,6 +2011,9 @@ static StereoOut32 DCFilter(StereoOut32 input) {
 
 __forceinline void spu2Mix()
 {
+	if (s_tick_observer)
+		s_tick_observer(false, s_tick_observer_userdata);
+
 	// Note: Playmode 4 is SPDIF, which overrides other inputs.
 	StereoOut32 InputData[2] =
 		{
@@ -566,10 +2031,15 @@ __forceinline void spu2Mix()
 	WaveDump::WriteCore(1, CoreSrc_Input, InputData[1]);
 #endif
 
+	UpdateIrqWatch();
+	CheckSilentVoiceIrqSetup();
+
+	if (s_soa_mixer)
+		PredecodeVoiceBlocks();
+
 	// Todo: Replace me with memzero initializer!
 	VoiceMixSet VoiceData[2] = {VoiceMixSet::Empty, VoiceMixSet::Empty}; // mixed voice data for each core.
-	MixCoreVoices(VoiceData[0], 0);
-	MixCoreVoices(VoiceData[1], 1);
+	MixAllCoreVoices(VoiceData);
 
 	StereoOut32 Ext(Cores[0].Mix(VoiceData[0], InputData[0], StereoOut32::Empty));
 
@@ -616,13 +2086,16 @@ __forceinline void spu2Mix()
 	WaveDump::WriteCore(1, CoreSrc_External, Out);
 #endif
 
-	Host::WriteToSoundBuffer(Out);
+	WriteToOutputBlock(Out);
 
 	// Update AutoDMA output positioning
 	OutPos++;
 	if (OutPos >= 0x200)
 		OutPos = 0;
 
+	if (s_tick_observer)
+		s_tick_observer(true, s_tick_observer_userdata);
+
 	if constexpr (IsDevBuild)
 	{
 		// used to throttle the output rate of cache stat reports
@@ -1,8 +1,120 @@
+#pragma once
+
 #include "SPU2/defs.h"
 #include "Pcsx2Types.h"
 
+#include <atomic>
+
 namespace Host
 {
 	void WriteToSoundBuffer(s16 Left, s16 Right);
 	void WriteToSoundBuffer(StereoOut32 snd);
+
+	/// Hands \p frames interleaved stereo frames to the host audio buffer in a single write.
+	void WriteToSoundBuffer(const s16* samples, uint frames);
+
+	/// How many frames are waiting in the host audio buffer, and how many it can hold.
+	void GetSoundBufferLevel(uint* queued_frames, uint* capacity_frames);
+}
+
+namespace OESndOut
+{
+	/// Number of stereo frames the mixer accumulates before handing them to the host.
+	static constexpr uint BlockFrames = 256;
+
+	struct Statistics
+	{
+		std::atomic<u64> FramesWritten{0};
+		std::atomic<u64> BlocksWritten{0};
+		std::atomic<u64> Underruns{0}; ///< Host buffer had run dry when a block arrived.
+		std::atomic<u64> Overruns{0};  ///< Host buffer had no room left for a whole block.
+
+		// ADPCM decode cache, counted per block fetch. Stale means the block was cached with
+		// the same history, but SPU2 RAM has been written since. Predecoded blocks were
+		// decoded in a batch before the tick, so they are neither hits nor misses.
+		std::atomic<u64> CacheHits{0};
+		std::atomic<u64> CacheMisses{0};
+		std::atomic<u64> CacheStale{0};
+		std::atomic<u64> CachePredecoded{0};
+
+		// Rate control, as of the last block handed to the host.
+		std::atomic<u32> BufferedFrames{0}; ///< Smoothed host buffer fill.
+		std::atomic<s32> CorrectionPPM{0}; ///< Resampling ratio applied, positive when stretching.
+		std::atomic<u32> StretchPercent{100}; ///< Time-stretch tempo, 100 when not stretching.
+	};
+
+	extern Statistics g_stats;
+
+	/// Pushes any partially filled block to the host.
+	void Flush();
+
+	/// Hands mixed blocks to \p sink instead of the host while set, e.g. for offline rendering.
+	/// Pass nullptr to go back to the host.
+	using OutputSink = void (*)(const s16* samples, uint frames, void* userdata);
+	void SetOutputSink(OutputSink sink, void* userdata);
+
+	/// Called on every tick while set, once before anything is mixed (\p end false) and once
+	/// after (\p end true), e.g. to watch what changes between ticks. Pass nullptr to remove it.
+	using TickObserver = void (*)(bool end, void* userdata);
+	void SetTickObserver(TickObserver observer, void* userdata);
+
+	void ResetStatistics();
+
+	enum class Resampler : u8
+	{
+		Linear,
+		Cubic,
+	};
+
+	/// Resamples output on its way to the host to keep the host buffer half full, and
+	/// time-stretches it when the VM isn't running at 100% speed. On by default.
+	void SetRateControl(bool enabled);
+
+	/// Forgets the smoothed buffer fill and the resampler and stretcher history, so steering
+	/// starts over. Call after the audio stream breaks off: pause and resume, state loads and
+	/// resets. Anything not flushed yet goes through the fresh state.
+	void ResetRateControl();
+	void SetResampler(Resampler quality);
+
+	/// Audio latency: what's waiting in the host buffer plus the block being mixed.
+	float GetLatencyMs();
+
+	/// Switches between the structure-of-arrays voice mixer (the default) and the original
+	/// one-voice-at-a-time mixer. Both produce identical output.
+	void SetSoAMixer(bool enabled);
+	bool GetSoAMixer();
+
+	/// Lets stopped voices advance their address with plain increments between IRQ and block
+	/// boundary events, instead of running the full fetch logic every step. On by default.
+	void SetSilentVoiceFastPath(bool enabled);
+	bool GetSilentVoiceFastPath();
+
+	enum class Interpolation : u8
+	{
+		Gaussian, ///< The SPU2's own, the default.
+		Cubic,    ///< Catmull-Rom, brighter but not what the hardware does.
+	};
+
+	void SetInterpolation(Interpolation mode);
+
+	/// Computes reverb buffer addresses from offsets cached per register setting instead
+	/// of dividing for every tap. On by default, output is identical to V_Core::DoReverb.
+	void SetFastReverb(bool enabled);
+	bool GetFastReverb();
+
+	/// Decodes \p iterations batches of random ADPCM blocks with both the batched and the
+	/// scalar decoder and checks that samples and predictor history match exactly.
+	bool TestADPCMDecoder(u32 iterations, u32 seed = 0);
+
+	/// Checks the SIMD interpolation kernel against the scalar interpolators over
+	/// \p iterations sets of random samples and phases, for both tables.
+	bool TestInterpolation(u32 iterations, u32 seed = 0);
+
+	/// Times the scalar gaussian interpolator against the SIMD kernel and logs both.
+	void BenchmarkInterpolation(u32 iterations);
+
+	/// Runs \p iterations sets of random reverb registers, SPU2 RAM and input through both
+	/// the fast reverb and V_Core::DoReverb and checks that output, RAM and core state match.
+	/// Uses core 0 and SPU2 RAM as scratch space and restores them, so run it paused.
+	bool TestReverb(u32 iterations, u32 seed = 0);
 }
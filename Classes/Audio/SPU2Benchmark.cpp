@@ -0,0 +1,660 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "PrecompiledHeader.h"
+#include "SPU2Benchmark.h"
+#include "OESndOut.h"
+
+#include "SPU2/defs.h"
+#include "SPU2/spu2.h"
+#include "SaveState.h"
+
+#include "common/Console.h"
+#include "common/FileSystem.h"
+#include "common/Timer.h"
+#include "common/ZipHelpers.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <optional>
+#include <vector>
+#include <zlib.h>
+
+void spu2Mix();
+
+namespace SPU2Benchmark
+{
+	enum EventKind : u16
+	{
+		EVENT_WRITE = 0,
+		EVENT_DMA4 = 1,
+		EVENT_DMA7 = 2,
+	};
+
+	struct Event
+	{
+		u32 sample;
+		u16 kind;
+		u32 arg;
+		u32 value;
+		std::vector<u16> data;
+	};
+
+	struct MixerSettings
+	{
+		bool soa_mixer;
+		bool silent_fast_path;
+		bool fast_reverb;
+	};
+
+	struct OutputCapture
+	{
+		u32 crc;
+		std::vector<s16> samples; ///< Only kept when writing a WAV.
+		bool keep;
+	};
+
+	/// Voice state that only changes between ticks when the voice is keyed on or off.
+	struct RecordedVoice
+	{
+		u32 next_addr;
+		s32 envelope;
+		int phase;
+	};
+
+	struct Recorder
+	{
+		static constexpr u32 RegisterCount = 0x400;
+		static constexpr u32 RamSize = 0x100000; ///< Halfwords.
+		static constexpr u32 BlockSize = 8; ///< Halfwords, DMA writes start at multiples of this.
+
+		FileSystem::ManagedCFilePtr fp;
+		std::string path;
+		u32 sample;
+		u32 samples;
+		u32 events;
+		bool failed;
+		u16 regs[RegisterCount];
+		u32 tsa[2];
+		RecordedVoice voices[2][V_Core::NumVoices];
+		std::vector<s16> ram;
+	};
+
+	static std::unique_ptr<Recorder> s_recorder;
+
+	static bool ReadState(const std::string& path, std::vector<u8>* data);
+	static bool ReadEvents(const std::string& path, std::vector<Event>* events);
+	static bool WriteWAV(const std::string& path, const std::vector<s16>& samples);
+	static void CaptureOutput(const s16* samples, uint frames, void* userdata);
+	static MixerSettings GetMixerSettings();
+	static void ApplyMixerSettings(const MixerSettings& settings);
+	static bool IsRecordedRegister(u32 addr);
+	static bool IsEffectsArea(u32 addr);
+	static void WriteEvent(Recorder& rec, u16 kind, u32 arg, const void* payload, size_t payload_size);
+	static void RecordWrite(Recorder& rec, u32 addr, u16 value);
+	static void RecordChanges(Recorder& rec);
+	static void SnapshotRecorder(Recorder& rec);
+	static void RecordTick(bool end, void* userdata);
+} // namespace SPU2Benchmark
+
+bool SPU2Benchmark::ReadState(const std::string& path, std::vector<u8>* data)
+{
+	// Savestates are zips, take the SPU2 entry out of it. Anything else is a raw freeze blob.
+	zip_error_t ze = {};
+	auto zf = zip_open_managed(path.c_str(), ZIP_RDONLY, &ze);
+	if (zf)
+	{
+		auto zff = zip_fopen_managed(zf.get(), "SPU2.bin", 0);
+		std::optional<std::vector<u8>> entry;
+		if (zff)
+			entry = ReadBinaryFileInZip(zff.get());
+		if (!entry.has_value())
+			return false;
+
+		*data = std::move(entry.value());
+		return true;
+	}
+
+	std::optional<std::vector<u8>> contents = FileSystem::ReadBinaryFile(path.c_str());
+	if (!contents.has_value())
+		return false;
+
+	*data = std::move(contents.value());
+	return true;
+}
+
+bool SPU2Benchmark::ReadEvents(const std::string& path, std::vector<Event>* events)
+{
+	std::optional<std::vector<u8>> contents = FileSystem::ReadBinaryFile(path.c_str());
+	if (!contents.has_value() || contents->size() < 8 || std::memcmp(contents->data(), "SPU2EVT1", 8) != 0)
+		return false;
+
+	const u8* ptr = contents->data() + 8;
+	const u8* const end = contents->data() + contents->size();
+	auto read = [&ptr, end](void* dest, size_t size) {
+		if (static_cast<size_t>(end - ptr) < size)
+			return false;
+		std::memcpy(dest, ptr, size);
+		ptr += size;
+		return true;
+	};
+
+	while (ptr != end)
+	{
+		Event ev = {};
+		u16 reserved;
+		if (!read(&ev.sample, sizeof(ev.sample)) || !read(&ev.kind, sizeof(ev.kind)) ||
+			!read(&reserved, sizeof(reserved)) || !read(&ev.arg, sizeof(ev.arg)))
+		{
+			return false;
+		}
+
+		if (!events->empty() && ev.sample < events->back().sample)
+			return false;
+
+		switch (ev.kind)
+		{
+			case EVENT_WRITE:
+				if (!read(&ev.value, sizeof(ev.value)))
+					return false;
+				break;
+
+			case EVENT_DMA4:
+			case EVENT_DMA7:
+				ev.data.resize(ev.arg);
+				if (!read(ev.data.data(), ev.data.size() * sizeof(u16)))
+					return false;
+				break;
+
+			default:
+				return false;
+		}
+
+		events->push_back(std::move(ev));
+	}
+
+	return true;
+}
+
+bool SPU2Benchmark::WriteWAV(const std::string& path, const std::vector<s16>& samples)
+{
+	auto fp = FileSystem::OpenManagedCFile(path.c_str(), "wb");
+	if (!fp)
+		return false;
+
+	const u32 data_size = static_cast<u32>(samples.size() * sizeof(s16));
+	const u32 riff_size = 36 + data_size;
+	const u16 format = 1, channels = 2, block_align = 4, bits = 16;
+	const u32 fmt_size = 16, rate = 48000, byte_rate = 48000 * 4;
+
+	bool result = true;
+	auto write = [&fp, &result](const void* data, size_t size) {
+		result = result && std::fwrite(data, size, 1, fp.get()) == 1;
+	};
+
+	write("RIFF", 4);
+	write(&riff_size, 4);
+	write("WAVEfmt ", 8);
+	write(&fmt_size, 4);
+	write(&format, 2);
+	write(&channels, 2);
+	write(&rate, 4);
+	write(&byte_rate, 4);
+	write(&block_align, 2);
+	write(&bits, 2);
+	write("data", 4);
+	write(&data_size, 4);
+	if (data_size > 0)
+		write(samples.data(), data_size);
+
+	return result;
+}
+
+void SPU2Benchmark::CaptureOutput(const s16* samples, uint frames, void* userdata)
+{
+	OutputCapture* capture = static_cast<OutputCapture*>(userdata);
+	capture->crc = static_cast<u32>(crc32(capture->crc, reinterpret_cast<const Bytef*>(samples), frames * 2 * sizeof(s16)));
+	if (capture->keep)
+		capture->samples.insert(capture->samples.end(), samples, samples + frames * 2);
+}
+
+SPU2Benchmark::MixerSettings SPU2Benchmark::GetMixerSettings()
+{
+	return {OESndOut::GetSoAMixer(), OESndOut::GetSilentVoiceFastPath(), OESndOut::GetFastReverb()};
+}
+
+void SPU2Benchmark::ApplyMixerSettings(const MixerSettings& settings)
+{
+	OESndOut::SetSoAMixer(settings.soa_mixer);
+	OESndOut::SetSilentVoiceFastPath(settings.silent_fast_path);
+	OESndOut::SetFastReverb(settings.fast_reverb);
+}
+
+bool SPU2Benchmark::Run(const Options& options, Result* result)
+{
+	std::vector<u8> state;
+	if (!ReadState(options.state_path, &state))
+	{
+		Console.Error("(SPU2Benchmark) Failed to read SPU2 state from '%s'.", options.state_path.c_str());
+		return false;
+	}
+
+	std::vector<Event> events;
+	if (!options.events_path.empty() && !ReadEvents(options.events_path, &events))
+	{
+		Console.Error("(SPU2Benchmark) Failed to read events from '%s'.", options.events_path.c_str());
+		return false;
+	}
+
+	// Keep the live state, to put back afterwards.
+	freezeData fd = {0, nullptr};
+	if (SPU2freeze(FreezeAction::Size, &fd) != 0 || static_cast<size_t>(fd.size) != state.size())
+	{
+		Console.Error("(SPU2Benchmark) SPU2 state is %zu bytes, expected %d.", state.size(), fd.size);
+		return false;
+	}
+
+	std::vector<u8> saved(fd.size);
+	fd.data = saved.data();
+	if (SPU2freeze(FreezeAction::Save, &fd) != 0)
+		return false;
+
+	fd.data = state.data();
+	if (SPU2freeze(FreezeAction::Load, &fd) != 0)
+	{
+		Console.Error("(SPU2Benchmark) Failed to load SPU2 state.");
+		fd.data = saved.data();
+		SPU2freeze(FreezeAction::Load, &fd);
+		return false;
+	}
+
+	OutputCapture capture = {static_cast<u32>(crc32(0, nullptr, 0)), {}, !options.wav_path.empty()};
+	if (capture.keep)
+		capture.samples.reserve(static_cast<size_t>(options.samples) * 2);
+
+	OESndOut::Flush();
+	OESndOut::SetOutputSink(&CaptureOutput, &capture);
+
+	const u64 hits = OESndOut::g_stats.CacheHits.load(std::memory_order_relaxed);
+	const u64 misses = OESndOut::g_stats.CacheMisses.load(std::memory_order_relaxed);
+	const u64 stale = OESndOut::g_stats.CacheStale.load(std::memory_order_relaxed);
+	const u64 predecoded = OESndOut::g_stats.CachePredecoded.load(std::memory_order_relaxed);
+
+	const MixerSettings saved_settings = GetMixerSettings();
+	const bool fast_paths = !options.reference_mixer;
+	ApplyMixerSettings({fast_paths, fast_paths, fast_paths});
+
+	// IRQs raised by the replay are only flagged here, and the IOP picks them up the next
+	// time the SPU2 runs. Whatever gets flagged during the run is thrown away afterwards.
+	bool saved_irq[2], saved_irq_dma[2];
+	std::memcpy(saved_irq, has_to_call_irq, sizeof(saved_irq));
+	std::memcpy(saved_irq_dma, has_to_call_irq_dma, sizeof(saved_irq_dma));
+
+	size_t next_event = 0;
+	Common::Timer timer;
+	for (u32 sample = 0; sample < options.samples; sample++)
+	{
+		for (; next_event < events.size() && events[next_event].sample <= sample; next_event++)
+		{
+			Event& ev = events[next_event];
+			if (ev.kind == EVENT_WRITE)
+				SPU2write(ev.arg, static_cast<u16>(ev.value));
+			else if (ev.kind == EVENT_DMA4)
+				SPU2writeDMA4Mem(ev.data.data(), ev.arg);
+			else
+				SPU2writeDMA7Mem(ev.data.data(), ev.arg);
+		}
+
+		spu2Mix();
+	}
+	OESndOut::Flush();
+	const double seconds = timer.GetTimeSeconds();
+
+	OESndOut::SetOutputSink(nullptr, nullptr);
+	ApplyMixerSettings(saved_settings);
+	std::memcpy(has_to_call_irq, saved_irq, sizeof(saved_irq));
+	std::memcpy(has_to_call_irq_dma, saved_irq_dma, sizeof(saved_irq_dma));
+	fd.data = saved.data();
+	SPU2freeze(FreezeAction::Load, &fd);
+
+	Result res = {};
+	res.samples = options.samples;
+	res.seconds = seconds;
+	res.samples_per_second = (seconds > 0.0) ? (options.samples / seconds) : 0.0;
+	res.ns_per_voice_sample = (options.samples > 0) ? (seconds * 1e9 / (static_cast<double>(options.samples) * 2 * V_Core::NumVoices)) : 0.0;
+	res.cache_hits = OESndOut::g_stats.CacheHits.load(std::memory_order_relaxed) - hits;
+	res.cache_misses = OESndOut::g_stats.CacheMisses.load(std::memory_order_relaxed) - misses;
+	res.cache_stale = OESndOut::g_stats.CacheStale.load(std::memory_order_relaxed) - stale;
+	res.cache_predecoded = OESndOut::g_stats.CachePredecoded.load(std::memory_order_relaxed) - predecoded;
+	res.output_crc = capture.crc;
+
+	const u64 lookups = res.cache_hits + res.cache_misses + res.cache_stale + res.cache_predecoded;
+	Console.WriteLn("(SPU2Benchmark) %s mixer, %llu samples in %.3f s: %.0f samples/s (%.1fx realtime), %.2f ns per voice-sample",
+		options.reference_mixer ? "Reference" : "Fast", static_cast<unsigned long long>(res.samples), res.seconds, res.samples_per_second, res.samples_per_second / 48000.0,
+		res.ns_per_voice_sample);
+	Console.WriteLn("(SPU2Benchmark) Decode cache: %.1f%% hits (%llu hits, %llu misses, %llu stale, %llu predecoded), output CRC %08X",
+		lookups ? (100.0 * res.cache_hits / lookups) : 0.0, static_cast<unsigned long long>(res.cache_hits),
+		static_cast<unsigned long long>(res.cache_misses), static_cast<unsigned long long>(res.cache_stale),
+		static_cast<unsigned long long>(res.cache_predecoded), res.output_crc);
+
+	if (capture.keep && !WriteWAV(options.wav_path, capture.samples))
+		Console.Error("(SPU2Benchmark) Failed to write '%s'.", options.wav_path.c_str());
+
+	if (result)
+		*result = res;
+
+	return true;
+}
+
+// --------------------------------------------------------------------------------------
+//  Event recorder
+// --------------------------------------------------------------------------------------
+// The register write and DMA code is part of the SPU2 in the submodule, so the recorder
+// can't see individual writes. Instead it looks at what changed between the end of one tick
+// and the start of the next, which is when the IOP gets to run, and writes that out as the
+// events that would have caused it:
+//   - Registers that differ are recorded as writes of their new value. Registers the SPU2
+//     changes by itself (ENVX, VOLX, NAX, ENDX, STATX, the current master volume) are left
+//     out, as are KON/KOFF and TSA, which are handled below.
+//   - Voices that were keyed on or off are recorded as KON/KOFF writes. A key on puts the
+//     voice back at the start of its attack, a key off puts it into release.
+//   - When a core's TSA moved, SPU2 RAM above SPU2_DYN_MEMLINE is compared against a copy
+//     and every changed range is recorded as a TSA write and a DMA of the new contents,
+//     followed by a TSA write of the final value. The reverb work areas are skipped while
+//     reverb is on, the mixer writes to those itself.
+// Only the net effect of each gap is kept. Several writes to one register become the last
+// one, KOFF comes before KON, and everything comes before the KON, which is the order games
+// set voices up in anyway. Streamed ADMA input isn't recorded.
+
+bool SPU2Benchmark::IsRecordedRegister(u32 addr)
+{
+	// Current master volumes, one set per core.
+	if (addr >= 0x760 && addr < 0x7B0)
+	{
+		const u32 offset = (addr - 0x760) % 0x28;
+		return (offset != 0x10 && offset != 0x12);
+	}
+
+	if (addr >= 0x760)
+		return true;
+
+	const u32 offset = addr & 0x3FF;
+	if (offset < 0x180)
+		return ((offset & 0xF) < 0xA); // ENVX, VOLXL, VOLXR
+	if (offset >= 0x1A0 && offset < 0x1AE)
+		return false; // KON, KOFF, TSA, data port
+	if (offset >= 0x1C0 && offset < 0x2E0)
+		return ((offset - 0x1C0) % 12 < 8); // NAX
+	if (offset >= 0x340 && offset < 0x346)
+		return false; // ENDX, STATX
+
+	return true;
+}
+
+bool SPU2Benchmark::IsEffectsArea(u32 addr)
+{
+	for (const V_Core& core : Cores)
+	{
+		if (core.FxEnable && addr + Recorder::BlockSize > core.EffectsStartA && addr <= core.EffectsEndA)
+			return true;
+	}
+
+	return false;
+}
+
+void SPU2Benchmark::WriteEvent(Recorder& rec, u16 kind, u32 arg, const void* payload, size_t payload_size)
+{
+	const u16 reserved = 0;
+	std::FILE* fp = rec.fp.get();
+	rec.failed |= (std::fwrite(&rec.sample, sizeof(rec.sample), 1, fp) != 1 || std::fwrite(&kind, sizeof(kind), 1, fp) != 1 ||
+				   std::fwrite(&reserved, sizeof(reserved), 1, fp) != 1 || std::fwrite(&arg, sizeof(arg), 1, fp) != 1 ||
+				   std::fwrite(payload, payload_size, 1, fp) != 1);
+	rec.events++;
+}
+
+void SPU2Benchmark::RecordWrite(Recorder& rec, u32 addr, u16 value)
+{
+	const u32 value32 = value;
+	WriteEvent(rec, EVENT_WRITE, 0x1f900000 | addr, &value32, sizeof(value32));
+}
+
+void SPU2Benchmark::RecordChanges(Recorder& rec)
+{
+	for (u32 i = 0; i < Recorder::RegisterCount; i++)
+	{
+		if (regtable[i] && IsRecordedRegister(i * 2) && *regtable[i] != rec.regs[i])
+			RecordWrite(rec, i * 2, *regtable[i]);
+	}
+
+	for (u32 core = 0; core < 2; core++)
+	{
+		if (Cores[core].TSA == rec.tsa[core])
+			continue;
+
+		// Either core's DMA lands in the same RAM, so everything goes through this one.
+		const u32 tsa_reg = core ? 0x5A8 : 0x1A8;
+		u32 addr = SPU2_DYN_MEMLINE;
+		while (addr < Recorder::RamSize)
+		{
+			const auto changed = [&rec](u32 block) {
+				return !IsEffectsArea(block) && std::memcmp(&rec.ram[block], GetMemPtr(block), Recorder::BlockSize * sizeof(s16)) != 0;
+			};
+
+			if (!changed(addr))
+			{
+				addr += Recorder::BlockSize;
+				continue;
+			}
+
+			// Short unchanged gaps are cheaper to send along than to start a new DMA for.
+			u32 end = addr + Recorder::BlockSize;
+			for (u32 next = end; next < Recorder::RamSize && next <= end + 4 * Recorder::BlockSize; next += Recorder::BlockSize)
+			{
+				if (changed(next))
+					end = next + Recorder::BlockSize;
+			}
+
+			RecordWrite(rec, tsa_reg, static_cast<u16>(addr >> 16));
+			RecordWrite(rec, tsa_reg + 2, static_cast<u16>(addr & 0xFFFF));
+			WriteEvent(rec, core ? EVENT_DMA7 : EVENT_DMA4, end - addr, GetMemPtr(addr), (end - addr) * sizeof(s16));
+			std::memcpy(&rec.ram[addr], GetMemPtr(addr), (end - addr) * sizeof(s16));
+			addr = end;
+		}
+
+		RecordWrite(rec, tsa_reg, static_cast<u16>(Cores[core].TSA >> 16));
+		RecordWrite(rec, tsa_reg + 2, static_cast<u16>(Cores[core].TSA & 0xFFFF));
+	}
+
+	for (u32 core = 0; core < 2; core++)
+	{
+		u32 key_on = 0, key_off = 0;
+		for (u32 voice = 0; voice < V_Core::NumVoices; voice++)
+		{
+			const V_Voice& vc = Cores[core].Voices[voice];
+			const RecordedVoice& was = rec.voices[core][voice];
+			if (vc.ADSR.Phase == V_ADSR::PHASE_ATTACK &&
+				(was.phase != V_ADSR::PHASE_ATTACK || was.next_addr != vc.NextA || was.envelope != vc.ADSR.Value))
+			{
+				key_on |= 1u << voice;
+			}
+			else if (vc.ADSR.Phase == V_ADSR::PHASE_RELEASE && was.phase != V_ADSR::PHASE_RELEASE)
+			{
+				key_off |= 1u << voice;
+			}
+		}
+
+		const u32 base = core ? 0x400 : 0;
+		if (key_off & 0xFFFF)
+			RecordWrite(rec, base + 0x1A4, static_cast<u16>(key_off));
+		if (key_off >> 16)
+			RecordWrite(rec, base + 0x1A6, static_cast<u16>(key_off >> 16));
+		if (key_on & 0xFFFF)
+			RecordWrite(rec, base + 0x1A0, static_cast<u16>(key_on));
+		if (key_on >> 16)
+			RecordWrite(rec, base + 0x1A2, static_cast<u16>(key_on >> 16));
+	}
+}
+
+void SPU2Benchmark::SnapshotRecorder(Recorder& rec)
+{
+	for (u32 i = 0; i < Recorder::RegisterCount; i++)
+		rec.regs[i] = regtable[i] ? *regtable[i] : 0;
+
+	for (u32 core = 0; core < 2; core++)
+	{
+		rec.tsa[core] = Cores[core].TSA;
+		for (u32 voice = 0; voice < V_Core::NumVoices; voice++)
+		{
+			const V_Voice& vc = Cores[core].Voices[voice];
+			rec.voices[core][voice] = {vc.NextA, vc.ADSR.Value, vc.ADSR.Phase};
+		}
+	}
+}
+
+void SPU2Benchmark::RecordTick(bool end, void* userdata)
+{
+	Recorder& rec = *static_cast<Recorder*>(userdata);
+	if (!end)
+	{
+		RecordChanges(rec);
+		return;
+	}
+
+	// What the mixer itself changed isn't an event.
+	SnapshotRecorder(rec);
+	if (++rec.sample >= rec.samples)
+		StopRecording();
+}
+
+bool SPU2Benchmark::StartRecording(const std::string& events_path, const std::string& state_path, u32 samples)
+{
+	StopRecording();
+
+	freezeData fd = {0, nullptr};
+	if (SPU2freeze(FreezeAction::Size, &fd) != 0)
+		return false;
+
+	std::vector<u8> state(fd.size);
+	fd.data = state.data();
+	if (SPU2freeze(FreezeAction::Save, &fd) != 0 || !FileSystem::WriteBinaryFile(state_path.c_str(), state.data(), state.size()))
+	{
+		Console.Error("(SPU2Benchmark) Failed to write the SPU2 state to '%s'.", state_path.c_str());
+		return false;
+	}
+
+	std::unique_ptr<Recorder> rec = std::make_unique<Recorder>();
+	rec->fp = FileSystem::OpenManagedCFile(events_path.c_str(), "wb");
+	if (!rec->fp || std::fwrite("SPU2EVT1", 8, 1, rec->fp.get()) != 1)
+	{
+		Console.Error("(SPU2Benchmark) Failed to create '%s'.", events_path.c_str());
+		return false;
+	}
+
+	rec->path = events_path;
+	rec->sample = 0;
+	rec->samples = samples;
+	rec->events = 0;
+	rec->failed = false;
+	rec->ram.assign(GetMemPtr(0), GetMemPtr(0) + Recorder::RamSize);
+	SnapshotRecorder(*rec);
+
+	Console.WriteLn("(SPU2Benchmark) Recording %u samples of SPU2 events to '%s', starting from the state in '%s'.",
+		samples, events_path.c_str(), state_path.c_str());
+	OESndOut::SetTickObserver(&RecordTick, rec.get());
+	s_recorder = std::move(rec);
+	return true;
+}
+
+void SPU2Benchmark::StopRecording()
+{
+	if (!s_recorder)
+		return;
+
+	OESndOut::SetTickObserver(nullptr, nullptr);
+	s_recorder->failed |= (std::fflush(s_recorder->fp.get()) != 0);
+	if (s_recorder->failed)
+		Console.Error("(SPU2Benchmark) Failed to write events to '%s'.", s_recorder->path.c_str());
+	else
+		Console.WriteLn("(SPU2Benchmark) Recorded %u events over %u samples to '%s'.", s_recorder->events, s_recorder->sample, s_recorder->path.c_str());
+
+	s_recorder.reset();
+}
+
+bool SPU2Benchmark::RunSelfTests(u32 iterations)
+{
+	bool passed = true;
+	passed &= OESndOut::TestADPCMDecoder(iterations);
+	passed &= OESndOut::TestInterpolation(iterations);
+	passed &= OESndOut::TestReverb(iterations);
+
+	if (passed)
+		Console.WriteLn("(SPU2Benchmark) All self-tests passed.");
+	else
+		Console.Error("(SPU2Benchmark) Self-tests FAILED, see above.");
+
+	return passed;
+}
+
+void SPU2Benchmark::RunFromEnvironment()
+{
+	if (const char* env = std::getenv("OE_SPU2_SELFTEST"))
+	{
+		const u32 iterations = static_cast<u32>(std::strtoul(env, nullptr, 10));
+		RunSelfTests(iterations ? iterations : 1000);
+	}
+
+	if (const char* env = std::getenv("OE_SPU2_INTERPOLATION_BENCHMARK"))
+	{
+		const u32 iterations = static_cast<u32>(std::strtoul(env, nullptr, 10));
+		OESndOut::BenchmarkInterpolation(iterations ? iterations : 1000000);
+	}
+
+	if (const char* env = std::getenv("OE_SPU2_BENCHMARK"))
+	{
+		const auto get = [](const char* name) -> std::string {
+			const char* value = std::getenv(name);
+			return value ? value : "";
+		};
+
+		Options options;
+		options.state_path = env;
+		options.events_path = get("OE_SPU2_BENCHMARK_EVENTS");
+		options.wav_path = get("OE_SPU2_BENCHMARK_WAV");
+		options.reference_mixer = (get("OE_SPU2_BENCHMARK_REFERENCE") == "1");
+		if (const u32 seconds = static_cast<u32>(std::strtoul(get("OE_SPU2_BENCHMARK_SECONDS").c_str(), nullptr, 10)))
+			options.samples = seconds * 48000;
+
+		Run(options);
+	}
+
+	// Last, so the benchmarks above don't end up in the recording.
+	if (const char* env = std::getenv("OE_SPU2_RECORD_EVENTS"))
+	{
+		const char* state_path = std::getenv("OE_SPU2_RECORD_STATE");
+		const char* seconds_env = std::getenv("OE_SPU2_RECORD_SECONDS");
+		const u32 seconds = seconds_env ? static_cast<u32>(std::strtoul(seconds_env, nullptr, 10)) : 0;
+		StartRecording(env, state_path ? state_path : std::string(env) + ".spu2", (seconds ? seconds : 60) * 48000);
+	}
+}
@@ -0,0 +1,110 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "Pcsx2Types.h"
+
+#include <string>
+
+/// Offline SPU2 renderer for measuring and checking changes to the mixer in OESndOut.cpp.
+///
+/// Loads an SPU2 state, either a whole savestate (its SPU2.bin entry is used) or a raw
+/// SPU2 freeze blob, optionally replays a recorded stream of register writes and DMA
+/// against it, and runs spu2Mix() back to back with the host output disconnected. The
+/// mixed output is checksummed, so two builds can be compared for bit exactness as well
+/// as speed.
+///
+/// Event stream format, all little-endian: the 8 byte magic "SPU2EVT1", then records of
+///   u32 sample, u16 kind, u16 reserved, u32 arg
+/// followed for each kind by:
+///   kind 0, register write: arg is the register address, then one u32 holding the value
+///   kind 1/2, DMA to core 0/1: arg is the transfer length in halfwords, then the data
+///
+/// Event streams can be recorded from a running game with StartRecording(), see the notes
+/// in SPU2Benchmark.cpp for what is captured and how.
+///
+/// PCSX2GameCore calls RunFromEnvironment() once the VM has booted, before it starts
+/// running, and everything is reported in the log. The environment variables are:
+///   OE_SPU2_SELFTEST=<iterations>        runs RunSelfTests()
+///   OE_SPU2_INTERPOLATION_BENCHMARK=<iterations>
+///                                        runs OESndOut::BenchmarkInterpolation()
+///   OE_SPU2_BENCHMARK=<state path>       runs Run() on that state, with optionally
+///   OE_SPU2_BENCHMARK_EVENTS=<path>      an event stream to replay,
+///   OE_SPU2_BENCHMARK_WAV=<path>         where to write the output,
+///   OE_SPU2_BENCHMARK_SECONDS=<seconds>  how much to render (60 by default), and
+///   OE_SPU2_BENCHMARK_REFERENCE=1        to render with the reference mixer.
+///   OE_SPU2_RECORD_EVENTS=<path>         runs StartRecording() after everything else, with
+///   OE_SPU2_RECORD_STATE=<path>          where to write the state (<events path>.spu2 by
+///                                        default), and
+///   OE_SPU2_RECORD_SECONDS=<seconds>     how much to record (60 by default).
+/// The recorded state and events can be passed straight to OE_SPU2_BENCHMARK and
+/// OE_SPU2_BENCHMARK_EVENTS.
+///
+/// This runs on the CPU thread with the VM paused. The live SPU2 state and the mixer
+/// settings are put back afterwards, and IRQs raised during the replay are dropped rather
+/// than delivered to the IOP.
+namespace SPU2Benchmark
+{
+	struct Options
+	{
+		std::string state_path;
+		std::string events_path; ///< Optional.
+		std::string wav_path; ///< Optional, writes the rendered output.
+		u32 samples = 48000 * 60;
+		/// Renders with the fast paths in the mixer switched off (SoA mixing, stopped voice
+		/// skipping, fast reverb), for comparing against. Otherwise they are all on.
+		bool reference_mixer = false;
+	};
+
+	struct Result
+	{
+		u64 samples;
+		double seconds;
+		double samples_per_second;
+		double ns_per_voice_sample; ///< Over all 48 voices, playing or not.
+		u64 cache_hits;
+		u64 cache_misses;
+		u64 cache_stale;
+		u64 cache_predecoded;
+		u32 output_crc; ///< CRC32 of the interleaved 16-bit output.
+	};
+
+	/// Renders and logs the result. Returns false if the state or events can't be loaded.
+	bool Run(const Options& options, Result* result = nullptr);
+
+	/// Writes the live SPU2 state to \p state_path, then records what the game does to the
+	/// SPU2 over the next \p samples ticks to \p events_path, in the format above.
+	/// Recording stops by itself after that, and the file is complete once it has.
+	bool StartRecording(const std::string& events_path, const std::string& state_path, u32 samples);
+	void StopRecording();
+
+	/// Checks the mixer's fast paths against the reference code they replace, over
+	/// \p iterations random inputs each. Returns false if any of them differ.
+	bool RunSelfTests(u32 iterations);
+
+	/// Runs whatever the OE_SPU2_* environment variables above ask for. Call on the CPU
+	/// thread once the VM is up.
+	void RunFromEnvironment();
+} // namespace SPU2Benchmark
@@ -26,6 +26,10 @@
 #import <OpenEmuBase/OETimingUtils.h>
 #import <OpenEmuBase/OERingBuffer.h>
 #include "Audio/OESndOut.h"
+#include "Audio/SPU2Benchmark.h"
+#include "Video/GSDumpReplayerBenchmark.h"
+#include "SaveState/OESaveState.h"
+#include "SaveState/RewindBuffer.h"
 #include "Input/keymap.h"
 
 #define BOOL PCSX2BOOL
@@ -49,19 +53,90 @@
 #include "USB/deviceproxy.h"
 #include "Error.h"
 #include "Host/AudioStream.h"
+#include "SaveState.h"
 #undef BOOL
 
 #include <OpenGL/gl3.h>
 #include <OpenGL/gl3ext.h>
 
-static bool ExitRequested = false;
-static bool WaitRequested = false;
-static bool isExecuting = false;
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+static std::atomic<bool> ExitRequested{false};
+
+// The VM thread sleeps on this whenever there is nothing for it to run (paused, waiting
+// on a state load, etc). Anything that changes what the thread should be doing bumps the
+// wake counter and notifies it.
+static std::mutex s_vm_thread_mutex;
+static std::condition_variable s_vm_thread_cv;
+static u64 s_vm_thread_wake_counter = 0;
+
+static void WakeVMThread()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_vm_thread_mutex);
+		s_vm_thread_wake_counter++;
+	}
+	s_vm_thread_cv.notify_all();
+}
+
+// Work handed to the VM thread from other threads (UI, OpenEmu's game thread). It is run at
+// safe points only: between VMManager::Execute() slices, and from PumpMessagesOnCPUThread()
+// on every vsync while the VM is running.
+static std::mutex s_cpu_thread_queue_mutex;
+static std::deque<std::function<void()>> s_cpu_thread_queue;
+static bool s_cpu_thread_queue_open = false;
+static std::atomic<std::thread::id> s_cpu_thread_id;
+
+static std::future<void> QueueOnCPUThread(std::function<void()> function)
+{
+	auto task = std::make_shared<std::packaged_task<void()>>(std::move(function));
+	std::future<void> result = task->get_future();
+
+	{
+		std::unique_lock<std::mutex> lock(s_cpu_thread_queue_mutex);
+		if (s_cpu_thread_queue_open) {
+			s_cpu_thread_queue.emplace_back([task]() { (*task)(); });
+			lock.unlock();
+			WakeVMThread();
+			return result;
+		}
+	}
+
+	// No VM thread to hand it to, so there's nothing to race with either.
+	(*task)();
+	return result;
+}
+
+static void ProcessCPUThreadQueue()
+{
+	std::unique_lock<std::mutex> lock(s_cpu_thread_queue_mutex);
+	while (!s_cpu_thread_queue.empty()) {
+		std::function<void()> function = std::move(s_cpu_thread_queue.front());
+		s_cpu_thread_queue.pop_front();
+		lock.unlock();
+		function();
+		lock.lock();
+	}
+}
 
 bool renderswitch = false;
 
 static NSString * const OEPSCSX2InternalResolution = @"OEPSCSX2InternalResolution";
 static NSString * const OEPSCSX2BlendingAccuracy = @"OEPSCSX2BlendingAccuracy";
+static NSString * const OEPSCSX2Rewind = @"OEPSCSX2Rewind";
+static NSString * const OEPSCSX2IncrementalSaveStates = @"OEPSCSX2IncrementalSaveStates";
+static NSString * const OEPSCSX2AudioInterpolation = @"OEPSCSX2AudioInterpolation";
+// Not a stored preference: picking it steps the rewind history back once.
+static NSString * const OEPSCSX2RewindStepBack = @"OEPSCSX2RewindStepBack";
 
 namespace GSDump
 {
@@ -91,6 +166,8 @@ PCSX2GameCore *_current;
 	NSMutableDictionary <NSString *, id> *_displayModes;
 	OEIntRect screenRect;
 	WindowInfo windowInfo;
+	// Savestates are captured on the VM thread, then compressed and written out here, in order.
+	dispatch_queue_t _saveStateQueue;
 }
 
 - (instancetype)init
@@ -100,8 +177,12 @@ PCSX2GameCore *_current;
 		_maxDiscs = 0;
 		_displayModes = [[NSMutableDictionary alloc] initWithDictionary:
 						 @{OEPSCSX2InternalResolution: @1,
-						   OEPSCSX2BlendingAccuracy: @1}];
+						   OEPSCSX2BlendingAccuracy: @1,
+						   OEPSCSX2Rewind: @NO,
+						   OEPSCSX2IncrementalSaveStates: @NO,
+						   OEPSCSX2AudioInterpolation: @0}];
 		screenRect = OEIntRectMake(0, 0, 640 * 4, 448 * 4);
+		_saveStateQueue = dispatch_queue_create("org.openemu.PCSX2.SaveState", DISPATCH_QUEUE_SERIAL);
 	}
 	return self;
 }
@@ -294,6 +375,7 @@ static NSURL *binCueFix(NSURL *path)
 - (void)resetEmulation
 {
 	VMManager::SetState(VMState::Resetting);
+	WakeVMThread();
 }
 
 - (void)setPauseEmulation:(BOOL)pauseEmulation
@@ -303,6 +385,7 @@ static NSURL *binCueFix(NSURL *path)
 	} else {
 		VMManager::SetState(VMState::Running);
 	}
+	WakeVMThread();
 	[super setPauseEmulation:pauseEmulation];
 }
 
@@ -314,12 +397,14 @@ static NSURL *binCueFix(NSURL *path)
 	[self.renderDelegate suspendFPSLimiting];
 	
 	params.filename = gamePath.fileSystemRepresentation;
+	// The state is loaded with our own loader once the VM is up, rather than by
+	// VMManager::Initialize().
+	std::string bootState;
 	if ([stateToLoad.path length] > 0) {
-		params.save_state = stateToLoad.fileSystemRepresentation;
+		bootState = stateToLoad.fileSystemRepresentation;
 		stateToLoad = nil;
-	} else {
-		params.save_state = "";
 	}
+	params.save_state = "";
 	params.source_type = CDVD_SourceType::Iso;
 	params.elf_override = "";
 	params.fast_boot = true;
@@ -329,13 +414,35 @@ static NSURL *binCueFix(NSURL *path)
 		VMManager::Internal::CPUThreadInitialize();
 		
 		VMManager::ApplySettings();
+
+		Rewind::Settings rewindSettings = Rewind::GetSettings();
+		rewindSettings.enabled = [_displayModes[OEPSCSX2Rewind] boolValue];
+		Rewind::SetSettings(rewindSettings);
+		OESndOut::SetInterpolation([_displayModes[OEPSCSX2AudioInterpolation] intValue] == 1 ?
+			OESndOut::Interpolation::Cubic : OESndOut::Interpolation::Gaussian);
+		SaveState_ConfigureFromEnvironment();
 		
+		// GS dump debugging aids, driven by environment variables. These have to be set
+		// before the dump is booted.
+		if (VMManager::IsGSDumpFileName(params.filename))
+			GSDumpReplayer::ConfigureFromEnvironment(&params.filename);
+
 		// TODO: handle needing to validate hardcore mode.
 		VMBootResult success = VMManager::Initialize(params);
 		if (VMBootResult::StartupSuccess == success) {
 			hasInitialized = true;
+			if (!bootState.empty()) {
+				// The VM thread isn't running yet, so this is still the CPU thread.
+				Error error;
+				if (!SaveState_LoadFile(bootState.c_str(), &error))
+					Console.Error("Failed to load '%s': %s", bootState.c_str(), error.GetDescription().c_str());
+			}
 			VMManager::SetState(VMState::Running);
 
+			// Debugging aids, driven by environment variables. The VM thread isn't running
+			// yet, so nothing else touches the SPU2 meanwhile.
+			SPU2Benchmark::RunFromEnvironment();
+
 			[NSThread detachNewThreadSelector:@selector(runVMThread:) toTarget:self withObject:nil];
 		}
 	}
@@ -348,43 +455,79 @@ static NSURL *binCueFix(NSURL *path)
 		abort();
 	}
 	OESetThreadRealtime(1. / 50, .007, .03); // guessed from bsnes
-		
+
+	s_cpu_thread_id = std::this_thread::get_id();
+	{
+		std::lock_guard<std::mutex> lock(s_cpu_thread_queue_mutex);
+		s_cpu_thread_queue_open = true;
+	}
+
 	while(!ExitRequested)
 	{
+		// Grab the wake counter before looking at the state, so a state change that lands
+		// between the check and the wait below still wakes us up.
+		u64 wake_counter;
+		{
+			std::lock_guard<std::mutex> lock(s_vm_thread_mutex);
+			wake_counter = s_vm_thread_wake_counter;
+		}
+
+		ProcessCPUThreadQueue();
+
+		const auto waitForWake = [wake_counter]() {
+			std::unique_lock<std::mutex> lock(s_vm_thread_mutex);
+			s_vm_thread_cv.wait(lock, [wake_counter]() {
+				return s_vm_thread_wake_counter != wake_counter || ExitRequested;
+			});
+		};
+
 		switch (VMManager::GetState())
 		{
 			case VMState::Shutdown:
-				continue;
-				
 			case VMState::Initializing:
-				continue;
-
 			case VMState::Paused:
+				// Don't leave the tail of the last block sitting in the mixer while we sleep,
+				// and start steering the host buffer from scratch once we're back.
+				OESndOut::Flush();
+				OESndOut::ResetRateControl();
+				waitForWake();
 				continue;
 
 			case VMState::Running:
-				if (!WaitRequested) {
-					isExecuting = true;
-					VMManager::Execute();
-					isExecuting = false;
-				}
+				VMManager::Execute();
 				continue;
 
 			case VMState::Resetting:
+				Rewind::Clear();
+				OESndOut::Flush();
+				OESndOut::ResetRateControl();
 				VMManager::Reset();
 				continue;
 
 			case VMState::Stopping:
+				OESndOut::Flush();
+				Rewind::Clear();
 				VMManager::Shutdown(true);
 				VMManager::Internal::CPUThreadShutdown();
 		}
 	}
+
+	// Anything still queued runs here so nobody is left blocked on a thread that has exited.
+	{
+		std::lock_guard<std::mutex> lock(s_cpu_thread_queue_mutex);
+		s_cpu_thread_queue_open = false;
+	}
+	ProcessCPUThreadQueue();
+	s_cpu_thread_id = std::thread::id();
 }
 
 - (void)stopEmulation
 {
+	// Let any savestates still being written finish before the VM goes away.
+	dispatch_sync(_saveStateQueue, ^{});
 	ExitRequested = true;
 	VMManager::SetState(VMState::Stopping);
+	WakeVMThread();
 	[super stopEmulation];
 }
 
@@ -523,14 +666,23 @@ static PadDualshock2* getPadToDualShock(const NSUInteger player)
 		return;
 	}
 	
-	WaitRequested = true;
-	while (isExecuting) {
-		usleep(50);
-	}
-	
+	// Make sure a save to the same file that's still in flight has landed first.
+	dispatch_sync(_saveStateQueue, ^{});
+
+	const std::string path(fileURL.fileSystemRepresentation);
 	Error theError = Error();
-	bool success = VMManager::LoadState(fileURL.fileSystemRepresentation, &theError);
-	WaitRequested = false;
+	bool success = false;
+	Host::RunOnCPUThread([&path, &theError, &success]() {
+		// Whatever was mixed before the load still belongs to the old timeline, so it goes
+		// out first rather than being glued onto the loaded state's audio.
+		OESndOut::Flush();
+		OESndOut::ResetRateControl();
+		success = SaveState_LoadFile(path.c_str(), &theError);
+		if (success) {
+			// The history leads up to the old timeline, not the one that was just loaded.
+			Rewind::Clear();
+		}
+	}, true);
 
 	block(success, success ? nil : [NSError errorWithDomain:OEGameCoreErrorDomain code:OEGameCoreCouldNotLoadStateError userInfo:@{NSLocalizedDescriptionKey: [NSString stringWithFormat: @"PCSX2 Could not load the current state: %s", theError.GetDescription().c_str()], NSURLErrorKey: fileURL}]);
 }
@@ -547,24 +699,54 @@ static PadDualshock2* getPadToDualShock(const NSUInteger player)
 					 NSURLErrorKey: fileURL}]);
 		return;
 	}
-	//TODO: verify that this works...
-	std::string hi = "";
-	VMManager::SaveState(fileURL.fileSystemRepresentation, false, false, [&hi](const std::string& err){
-		hi = err;
+	// Only capturing the state has to happen on the VM thread. Compressing it and writing it
+	// out happens on the save queue, so emulation carries on straight away.
+	// VMManager::SaveState() can also write on a thread, but it always goes through the
+	// single-threaded SaveState_ZipToDisk(), and it only reports the result through
+	// Host::OnSaveStateSaved() and the OSD, not back to the caller. We need the result, and
+	// the error, to complete the block, so the state is captured and written out here.
+	const std::string path(fileURL.fileSystemRepresentation);
+	const bool incremental = [_displayModes[OEPSCSX2IncrementalSaveStates] boolValue];
+	const std::string baseKey(DiscID ? DiscID.UTF8String : "");
+	ArchiveEntryList *srclist = nullptr;
+	SaveStateScreenshotData *screenshot = nullptr;
+	Host::RunOnCPUThread([&srclist, &screenshot]() {
+		srclist = SaveState_DownloadState().release();
+		screenshot = SaveState_SaveScreenshot().release();
+	}, true);
+
+	dispatch_async(_saveStateQueue, ^{
+		std::unique_ptr<ArchiveEntryList> state(srclist);
+		std::unique_ptr<SaveStateScreenshotData> thumbnail(screenshot);
+		Error theError = Error();
+		bool success = false;
+		if (!state) {
+			Error::SetString(&theError, "Failed to capture the VM state.");
+		} else if (incremental) {
+			success = SaveState_WriteIncremental(SaveState_GetEntries(*state), thumbnail.get(), path.c_str(), baseKey, &theError);
+		} else {
+			success = SaveState_WriteArchive(SaveState_GetEntries(*state), thumbnail.get(), path.c_str(), SaveState_GetCompression(), &theError);
+		}
+		if (success && !SaveState_SyncFileToDisk(path.c_str())) {
+			Error::SetErrno(&theError, "Failed to flush '" + path + "' to disk: ", errno);
+			success = false;
+		}
+		if (success) {
+			SaveState_RunBenchmarksFromEnvironment(SaveState_GetEntries(*state), thumbnail.get());
+		}
+
+		NSError *ourError = nil;
+		if (!success) {
+			NSBundle *ourBundle = [NSBundle bundleForClass:[self class]];
+			ourError = [NSError errorWithDomain:OEGameCoreErrorDomain
+										   code:OEGameCoreCouldNotSaveStateError
+									   userInfo:@{NSLocalizedDescriptionKey:
+													  [NSString localizedStringWithFormat: NSLocalizedStringWithDefaultValue(@"PCSX2_SAVE_STATE_FAIL", @"Localizable", ourBundle, @"PCSX2 Could not save the current state: %s", @"PCSX2 Could not save the current state: followed by a C string."), theError.GetDescription().c_str()],
+												  NSURLErrorKey: fileURL}];
+		}
+
+		block(success, ourError);
 	});
-	
-	NSError *ourError = nil;
-	if (!hi.empty()) {
-		NSBundle *ourBundle = [NSBundle bundleForClass:[self class]];
-		ourError = [NSError errorWithDomain:OEGameCoreErrorDomain
-									   code:OEGameCoreCouldNotSaveStateError
-								   userInfo:@{NSLocalizedDescriptionKey:
-												  [NSString localizedStringWithFormat: NSLocalizedStringWithDefaultValue(@"PCSX2_SAVE_STATE_FAIL", @"Localizable", ourBundle, @"PCSX2 Could not save the current state: %s", @"PCSX2 Could not save the current state: followed by a C string."), hi.c_str()],
-											  NSURLErrorKey: fileURL}];
-	}
-	
-	block(hi.empty(), ourError);
-	
 }
 
 #pragma mark - Discs
@@ -581,7 +763,9 @@ static PadDualshock2* getPadToDualShock(const NSUInteger player)
 	
 	gamePath = ToPassBack;
 
-	VMManager::ChangeDisc(CDVD_SourceType::Iso, gamePath.fileSystemRepresentation);
+	Host::RunOnCPUThread([path = std::string(gamePath.fileSystemRepresentation)]() {
+		VMManager::ChangeDisc(CDVD_SourceType::Iso, path);
+	});
 }
 
 #pragma mark - Display Options
@@ -600,6 +784,9 @@ static PadDualshock2* getPadToDualShock(const NSUInteger player)
 	} defaultValues[] = {
 		{ OEPSCSX2InternalResolution,	[NSNumber class], @1  },
 		{ OEPSCSX2BlendingAccuracy,		[NSNumber class], @1  },
+		{ OEPSCSX2Rewind,				[NSNumber class], @NO },
+		{ OEPSCSX2IncrementalSaveStates,	[NSNumber class], @NO },
+		{ OEPSCSX2AudioInterpolation,	[NSNumber class], @0  },
 	};
 	/* validate the defaults to avoid crashes caused by users playing
 	 * around where they shouldn't */
@@ -644,6 +831,14 @@ static PadDualshock2* getPadToDualShock(const NSUInteger player)
 								OptionWithValue(NSLocalizedStringWithDefaultValue(@"PCSX2_BLENDING_ACCURACY_3", @"Localizable", ourBundle, @"High", @"High"), OEPSCSX2BlendingAccuracy, 3),
 								OptionWithValue(NSLocalizedStringWithDefaultValue(@"PCSX2_BLENDING_ACCURACY_4", @"Localizable", ourBundle, @"Full (Very Slow)", @"Full (Very Slow)"), OEPSCSX2BlendingAccuracy, 4),
 								OptionWithValue(NSLocalizedStringWithDefaultValue(@"PCSX2_BLENDING_ACCURACY_5", @"Localizable", ourBundle, @"Ultra (Ultra Slow, or Apple Silicon)", @"Ultra (Ultra Slow, or Apple Silicon)"), OEPSCSX2BlendingAccuracy, 5)]),
+		OEDisplayMode_Submenu(NSLocalizedStringWithDefaultValue(@"PCSX2_AUDIO_INTERPOLATION", @"Localizable", ourBundle, @"Audio Interpolation", @"Audio Interpolation"),
+							  @[OptionWithValue(NSLocalizedStringWithDefaultValue(@"PCSX2_AUDIO_INTERPOLATION_GAUSSIAN", @"Localizable", ourBundle, @"Gaussian (default)", @"Gaussian (default)"), OEPSCSX2AudioInterpolation, 0),
+								OptionWithValue(NSLocalizedStringWithDefaultValue(@"PCSX2_AUDIO_INTERPOLATION_CUBIC", @"Localizable", ourBundle, @"Cubic (Brighter)", @"Cubic (Brighter)"), OEPSCSX2AudioInterpolation, 1)]),
+		OEDisplayMode_Submenu(NSLocalizedStringWithDefaultValue(@"PCSX2_REWIND", @"Localizable", ourBundle, @"Rewind", @"Rewind"),
+							  @[OptionToggleable(NSLocalizedStringWithDefaultValue(@"PCSX2_REWIND_ENABLE", @"Localizable", ourBundle, @"Keep Rewind History", @"Keep Rewind History"), OEPSCSX2Rewind),
+								OptionWithValue(NSLocalizedStringWithDefaultValue(@"PCSX2_REWIND_STEP_BACK", @"Localizable", ourBundle, @"Step Back", @"Step Back"), OEPSCSX2RewindStepBack, 1)]),
+		OEDisplayMode_Submenu(NSLocalizedStringWithDefaultValue(@"PCSX2_SAVE_STATES", @"Localizable", ourBundle, @"Save States", @"Save States"),
+							  @[OptionToggleable(NSLocalizedStringWithDefaultValue(@"PCSX2_INCREMENTAL_SAVE_STATES", @"Localizable", ourBundle, @"Incremental Saves", @"Incremental Saves"), OEPSCSX2IncrementalSaveStates)]),
 	];
 	
 #undef OptionWithValue
@@ -658,16 +853,49 @@ static PadDualshock2* getPadToDualShock(const NSUInteger player)
 	if (key == nil) {
 		return;
 	}
+
+	if ([key isEqualToString:OEPSCSX2RewindStepBack]) {
+		Host::RunOnCPUThread([]() {
+			OESndOut::Flush();
+			OESndOut::ResetRateControl();
+			Rewind::StepBack();
+		});
+		return;
+	}
 	_displayModes[key] = currentVal;
 
+	INISettingsInterface *si = s_base_settings_interface.get();
+	const int value = [currentVal intValue];
+	std::function<void()> applyOption;
 	if ([key isEqualToString:OEPSCSX2InternalResolution]) {
-		s_base_settings_interface->SetIntValue("EmuCore/GS", "upscale_multiplier", [currentVal intValue]);
-		VMManager::RequestDisplaySize([currentVal floatValue]);
+		applyOption = [si, value]() {
+			si->SetIntValue("EmuCore/GS", "upscale_multiplier", value);
+			VMManager::RequestDisplaySize(static_cast<float>(value));
+		};
 	} else if ([key isEqualToString:OEPSCSX2BlendingAccuracy]) {
-		s_base_settings_interface->SetIntValue("EmuCore/GS", "accurate_blending_unit", [currentVal intValue]);
+		applyOption = [si, value]() {
+			si->SetIntValue("EmuCore/GS", "accurate_blending_unit", value);
+		};
+	} else if ([key isEqualToString:OEPSCSX2AudioInterpolation]) {
+		applyOption = [value]() {
+			OESndOut::SetInterpolation(value == 1 ? OESndOut::Interpolation::Cubic : OESndOut::Interpolation::Gaussian);
+		};
+	} else if ([key isEqualToString:OEPSCSX2Rewind]) {
+		applyOption = [value]() {
+			Rewind::Settings settings = Rewind::GetSettings();
+			settings.enabled = (value != 0);
+			Rewind::SetSettings(settings);
+		};
 	}
-	
-	VMManager::ApplySettings();
+
+	// Every option change goes through ApplySettings, so keys without special handling above
+	// still get picked up by the VM.
+	Host::RunOnCPUThread([applyOption = std::move(applyOption)]() {
+		if (applyOption) {
+			applyOption();
+		}
+		VMManager::ApplySettings();
+	});
 }
 
 @end
@@ -710,6 +938,31 @@ void Host::WriteToSoundBuffer(StereoOut32 snd)
 	Host::WriteToSoundBuffer(snd.Left, snd.Right);
 }
 
+void Host::WriteToSoundBuffer(const s16* samples, uint frames)
+{
+	GET_CURRENT_OR_RETURN();
+
+	OERingBuffer *buffer = [current audioBufferAtIndex:0];
+	const NSUInteger length = frames * 2 * sizeof(s16);
+	if (buffer.usedBytes == 0)
+		OESndOut::g_stats.Underruns.fetch_add(1, std::memory_order_relaxed);
+	if (buffer.freeBytes < length)
+		OESndOut::g_stats.Overruns.fetch_add(1, std::memory_order_relaxed);
+
+	[buffer write:samples maxLength:length];
+}
+
+void Host::GetSoundBufferLevel(uint* queued_frames, uint* capacity_frames)
+{
+	*queued_frames = 0;
+	*capacity_frames = 0;
+	GET_CURRENT_OR_RETURN();
+
+	OERingBuffer *buffer = [current audioBufferAtIndex:0];
+	*queued_frames = static_cast<uint>(buffer.usedBytes / (2 * sizeof(s16)));
+	*capacity_frames = static_cast<uint>(buffer.length / (2 * sizeof(s16)));
+}
+
 void Host::OnPerformanceMetricsUpdated()
 {
 }
@@ -793,6 +1046,10 @@ void Host::OnGameChanged(const std::string& title, const std::string& elf_overri
 
 void Host::PumpMessagesOnCPUThread()
 {
+	ProcessCPUThreadQueue();
+
+	// Called once per vsync while the VM runs, which is a safe point to snapshot it.
+	Rewind::OnVSync();
 }
 
 void Host::RequestResizeHostDisplay(s32 width, s32 height)
@@ -801,8 +1058,14 @@ void Host::RequestResizeHostDisplay(s32 width, s32 height)
 
 void Host::RunOnCPUThread(std::function<void()> function, bool block)
 {
-	//TODO: put this in the right thread...
-	function();
+	if (std::this_thread::get_id() == s_cpu_thread_id.load()) {
+		function();
+		return;
+	}
+
+	std::future<void> result = QueueOnCPUThread(std::move(function));
+	if (block)
+		result.wait();
 }
 
 void Host::RequestVMShutdown(bool allow_confirm, bool allow_save_state, bool default_save_state)
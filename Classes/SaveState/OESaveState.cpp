@@ -0,0 +1,1956 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "PrecompiledHeader.h"
+#include "OESaveState.h"
+#include "WorkerPool.h"
+
+#include "common/Console.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
+#include "common/Path.h"
+#include "common/ScopedGuard.h"
+#include "common/StringUtil.h"
+#include "common/Timer.h"
+#include "common/ZipHelpers.h"
+
+#include "COP0.h"
+#include "Cache.h"
+#include "Config.h"
+#include "Counters.h"
+#include "DebugTools/Breakpoints.h"
+#include "GSDumpReplayer.h"
+#include "Hw.h"
+#include "IopHw.h"
+#include "IopMem.h"
+#include "MTGS.h"
+#include "MTVU.h"
+#include "Memory.h"
+#include "SIO/Pad/Pad.h"
+#include "SPU2/spu2.h"
+#include "StateWrapper.h"
+#include "USB/USB.h"
+#include "VMManager.h"
+#include "VUmicro.h"
+#include "vtlb.h"
+
+#include "fmt/format.h"
+
+#include <algorithm>
+#include <atomic>
+#include <csetjmp>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <png.h>
+#include <webp/decode.h>
+#include <webp/encode.h>
+#include <zlib.h>
+#include <zstd.h>
+#include "xxhash.h"
+
+static constexpr const char* EntryFilename_StateVersion = "PCSX2 Savestate Version.id";
+static constexpr const char* EntryFilename_Screenshot = "Screenshot.png";
+static constexpr const char* EntryFilename_ScreenshotWebP = "Screenshot.webp";
+
+std::vector<SaveStateEntryData> SaveState_GetEntries(ArchiveEntryList& list)
+{
+	std::vector<SaveStateEntryData> entries;
+	entries.reserve(list.GetLength());
+	for (uint i = 0; i < list.GetLength(); i++)
+	{
+		const ArchiveEntry& entry = list[i];
+		if (entry.GetDataSize())
+			entries.push_back({entry.GetFilename(), list.GetPtr(entry.GetDataIndex()), entry.GetDataSize()});
+	}
+
+	return entries;
+}
+
+// --------------------------------------------------------------------------------------
+//  Screenshot
+// --------------------------------------------------------------------------------------
+
+// The thumbnail is encoded on the worker pool while the state itself is compressed. Plain PNG
+// is what upstream writes. FastPNG is still a regular PNG, but skips filtering and uses the
+// fastest deflate level, which is several times quicker for a slightly larger file. WebP
+// lossless is smaller still, and is stored as "Screenshot.webp". Upstream only looks for
+// "Screenshot.png", so it shows no thumbnail for those. SaveState_ReadThumbnail() goes by the
+// contents rather than the name, and reads all of them.
+
+static std::atomic<SaveStateThumbnailCodec> s_thumbnail_codec{SaveStateThumbnailCodec::FastPNG};
+
+void SaveState_SetThumbnailCodec(SaveStateThumbnailCodec codec)
+{
+	s_thumbnail_codec.store(codec, std::memory_order_relaxed);
+}
+
+SaveStateThumbnailCodec SaveState_GetThumbnailCodec()
+{
+	return s_thumbnail_codec.load(std::memory_order_relaxed);
+}
+
+void SaveState_ConfigureFromEnvironment()
+{
+	static constexpr std::pair<const char*, SaveStateThumbnailCodec> codecs[] = {
+		{"png", SaveStateThumbnailCodec::PNG},
+		{"fastpng", SaveStateThumbnailCodec::FastPNG},
+		{"webp", SaveStateThumbnailCodec::WebPLossless},
+	};
+
+	const char* env = std::getenv("OE_SAVESTATE_THUMBNAIL_CODEC");
+	if (!env)
+		return;
+
+	for (const auto& [name, codec] : codecs)
+	{
+		if (std::strcmp(env, name) == 0)
+		{
+			Console.WriteLn("(SaveState) Encoding thumbnails as %s.", name);
+			SaveState_SetThumbnailCodec(codec);
+			return;
+		}
+	}
+
+	Console.Error("(SaveState) Unknown thumbnail codec '%s', expected png, fastpng or webp.", env);
+}
+
+static bool SaveState_EncodeScreenshotPNG(const SaveStateScreenshotData* data, bool fast, std::vector<u8>* out)
+{
+	png_structp png_ptr = png_create_write_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	png_infop info_ptr = nullptr;
+	if (!png_ptr)
+		return false;
+
+	ScopedGuard cleanup([&png_ptr, &info_ptr]() {
+		if (png_ptr)
+			png_destroy_write_struct(&png_ptr, info_ptr ? &info_ptr : nullptr);
+	});
+
+	info_ptr = png_create_info_struct(png_ptr);
+	if (!info_ptr)
+		return false;
+
+	if (setjmp(png_jmpbuf(png_ptr)))
+		return false;
+
+	png_set_write_fn(png_ptr, out, [](png_structp png_ptr, png_bytep data_ptr, png_size_t size) {
+		std::vector<u8>* out = static_cast<std::vector<u8>*>(png_get_io_ptr(png_ptr));
+		out->insert(out->end(), data_ptr, data_ptr + size);
+	}, [](png_structp png_ptr) {});
+
+	if (fast)
+	{
+		png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+		png_set_compression_level(png_ptr, 1);
+	}
+	else
+	{
+		png_set_compression_level(png_ptr, 5);
+	}
+
+	png_set_IHDR(png_ptr, info_ptr, data->width, data->height, 8, PNG_COLOR_TYPE_RGBA,
+		PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+	png_write_info(png_ptr, info_ptr);
+
+	for (u32 y = 0; y < data->height; ++y)
+		png_write_row(png_ptr, reinterpret_cast<png_const_bytep>(&data->pixels[y * data->width]));
+
+	png_write_end(png_ptr, nullptr);
+	return true;
+}
+
+static bool SaveState_EncodeScreenshotWebP(const SaveStateScreenshotData* data, std::vector<u8>* out)
+{
+	u8* encoded = nullptr;
+	const size_t size = WebPEncodeLosslessRGBA(reinterpret_cast<const u8*>(data->pixels.data()),
+		static_cast<int>(data->width), static_cast<int>(data->height), static_cast<int>(data->width * sizeof(u32)), &encoded);
+	if (size == 0)
+		return false;
+
+	out->assign(encoded, encoded + size);
+	WebPFree(encoded);
+	return true;
+}
+
+static bool SaveState_EncodeScreenshot(SaveStateScreenshotData* data, SaveStateThumbnailCodec codec, std::vector<u8>* out)
+{
+	// ensure the alpha channel is set to opaque
+	for (u32& pixel : data->pixels)
+		pixel |= 0xFF000000u;
+
+	switch (codec)
+	{
+		case SaveStateThumbnailCodec::WebPLossless:
+			return SaveState_EncodeScreenshotWebP(data, out);
+
+		case SaveStateThumbnailCodec::FastPNG:
+			return SaveState_EncodeScreenshotPNG(data, true, out);
+
+		case SaveStateThumbnailCodec::PNG:
+		default:
+			return SaveState_EncodeScreenshotPNG(data, false, out);
+	}
+}
+
+static bool SaveState_AddScreenshotToZip(zip_t* zf, const std::vector<u8>& encoded, SaveStateThumbnailCodec codec)
+{
+	zip_error_t ze = {};
+	zip_source_t* const zs = zip_source_buffer_create(nullptr, 0, 0, &ze);
+	if (!zs)
+		return false;
+
+	ScopedGuard zs_free([zs]() { zip_source_free(zs); });
+
+	// The encoded data goes away before the zip is closed, so it has to be copied in.
+	if (zip_source_begin_write(zs) != 0 ||
+		zip_source_write(zs, encoded.data(), encoded.size()) != static_cast<zip_int64_t>(encoded.size()) ||
+		zip_source_commit_write(zs) != 0)
+	{
+		return false;
+	}
+
+	const char* name = (codec == SaveStateThumbnailCodec::WebPLossless) ? EntryFilename_ScreenshotWebP : EntryFilename_Screenshot;
+	const s64 file_index = zip_file_add(zf, name, zs, 0);
+	if (file_index < 0)
+		return false;
+
+	// png/webp are already compressed, no point doing it twice
+	zip_set_file_compression(zf, file_index, ZIP_CM_STORE, 0);
+
+	// source is now owned by the zip file
+	zs_free.Cancel();
+	return true;
+}
+
+static bool SaveState_DecodeScreenshotPNG(std::span<const u8> data, u32* out_width, u32* out_height, std::vector<u32>* out_pixels)
+{
+	png_structp png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, nullptr);
+	if (!png_ptr)
+		return false;
+
+	png_infop info_ptr = png_create_info_struct(png_ptr);
+	if (!info_ptr)
+	{
+		png_destroy_read_struct(&png_ptr, nullptr, nullptr);
+		return false;
+	}
+
+	ScopedGuard cleanup([&png_ptr, &info_ptr]() {
+		png_destroy_read_struct(&png_ptr, &info_ptr, nullptr);
+	});
+
+	if (setjmp(png_jmpbuf(png_ptr)))
+		return false;
+
+	png_set_read_fn(png_ptr, &data, [](png_structp png_ptr, png_bytep data_ptr, png_size_t size) {
+		std::span<const u8>* reader = static_cast<std::span<const u8>*>(png_get_io_ptr(png_ptr));
+		if (size > reader->size())
+			png_error(png_ptr, "Screenshot is truncated");
+
+		std::memcpy(data_ptr, reader->data(), size);
+		*reader = reader->subspan(size);
+	});
+
+	png_read_info(png_ptr, info_ptr);
+
+	png_uint_32 width = 0;
+	png_uint_32 height = 0;
+	int bitDepth = 0;
+	int colorType = -1;
+	if (png_get_IHDR(png_ptr, info_ptr, &width, &height, &bitDepth, &colorType, nullptr, nullptr, nullptr) != 1 ||
+		width == 0 || height == 0 || bitDepth != 8 || (colorType != PNG_COLOR_TYPE_RGB && colorType != PNG_COLOR_TYPE_RGBA))
+	{
+		return false;
+	}
+
+	const png_uint_32 bytesPerRow = png_get_rowbytes(png_ptr, info_ptr);
+	std::vector<u8> rowData(bytesPerRow);
+
+	*out_width = width;
+	*out_height = height;
+	out_pixels->resize(width * height);
+
+	for (u32 y = 0; y < height; y++)
+	{
+		png_read_row(png_ptr, static_cast<png_bytep>(rowData.data()), nullptr);
+
+		const u8* row_ptr = rowData.data();
+		u32* out_ptr = &out_pixels->at(y * width);
+		if (colorType == PNG_COLOR_TYPE_RGB)
+		{
+			for (u32 x = 0; x < width; x++)
+			{
+				u32 pixel = static_cast<u32>(*(row_ptr)++);
+				pixel |= static_cast<u32>(*(row_ptr)++) << 8;
+				pixel |= static_cast<u32>(*(row_ptr)++) << 16;
+				*(out_ptr++) = pixel | 0xFF000000u; // make opaque
+			}
+		}
+		else
+		{
+			for (u32 x = 0; x < width; x++)
+			{
+				u32 pixel;
+				std::memcpy(&pixel, row_ptr, sizeof(u32));
+				row_ptr += sizeof(u32);
+				*(out_ptr++) = pixel | 0xFF000000u; // make opaque
+			}
+		}
+	}
+
+	return true;
+}
+
+static bool SaveState_DecodeScreenshotWebP(std::span<const u8> data, u32* out_width, u32* out_height, std::vector<u32>* out_pixels)
+{
+	int width, height;
+	if (!WebPGetInfo(data.data(), data.size(), &width, &height) || width <= 0 || height <= 0)
+		return false;
+
+	out_pixels->resize(static_cast<size_t>(width) * static_cast<size_t>(height));
+	if (!WebPDecodeRGBAInto(data.data(), data.size(), reinterpret_cast<u8*>(out_pixels->data()),
+			out_pixels->size() * sizeof(u32), width * static_cast<int>(sizeof(u32))))
+	{
+		return false;
+	}
+
+	for (u32& pixel : *out_pixels)
+		pixel |= 0xFF000000u; // make opaque
+
+	*out_width = static_cast<u32>(width);
+	*out_height = static_cast<u32>(height);
+	return true;
+}
+
+static bool SaveState_DecodeScreenshot(std::span<const u8> data, u32* out_width, u32* out_height, std::vector<u32>* out_pixels)
+{
+	static constexpr u8 png_signature[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+	if (data.size() >= sizeof(png_signature) && std::memcmp(data.data(), png_signature, sizeof(png_signature)) == 0)
+		return SaveState_DecodeScreenshotPNG(data, out_width, out_height, out_pixels);
+
+	if (data.size() >= 12 && std::memcmp(data.data(), "RIFF", 4) == 0 && std::memcmp(data.data() + 8, "WEBP", 4) == 0)
+		return SaveState_DecodeScreenshotWebP(data, out_width, out_height, out_pixels);
+
+	return false;
+}
+
+bool SaveState_ReadThumbnail(const char* filename, u32* out_width, u32* out_height, std::vector<u32>* out_pixels)
+{
+	zip_error_t ze = {};
+	auto zf = zip_open_managed(filename, ZIP_RDONLY, &ze);
+	if (!zf)
+		return false;
+
+	zip_int64_t index = zip_name_locate(zf.get(), EntryFilename_Screenshot, 0);
+	if (index < 0)
+		index = zip_name_locate(zf.get(), EntryFilename_ScreenshotWebP, 0);
+
+	zip_stat_t zst;
+	if (index < 0 || zip_stat_index(zf.get(), index, 0, &zst) != 0 || !(zst.valid & ZIP_STAT_SIZE))
+		return false;
+
+	std::vector<u8> data(zst.size);
+	auto zff = zip_fopen_index_managed(zf.get(), index, 0);
+	if (!zff || zip_fread(zff.get(), data.data(), data.size()) != static_cast<zip_int64_t>(data.size()))
+		return false;
+
+	return SaveState_DecodeScreenshot(data, out_width, out_height, out_pixels);
+}
+
+void SaveState_BenchmarkThumbnailEncoders(const SaveStateScreenshotData& data)
+{
+	static constexpr u32 iterations = 5;
+	static constexpr std::pair<SaveStateThumbnailCodec, const char*> codecs[] = {
+		{SaveStateThumbnailCodec::PNG, "PNG"},
+		{SaveStateThumbnailCodec::FastPNG, "Fast PNG"},
+		{SaveStateThumbnailCodec::WebPLossless, "WebP lossless"},
+	};
+
+	Console.WriteLn("(SaveState) Thumbnail encoder benchmark, %ux%u, best of %u runs:", data.width, data.height, iterations);
+	for (const auto& [codec, name] : codecs)
+	{
+		double best_encode_ms = std::numeric_limits<double>::max();
+		double best_decode_ms = std::numeric_limits<double>::max();
+		size_t encoded_size = 0;
+		for (u32 i = 0; i < iterations; i++)
+		{
+			SaveStateScreenshotData copy = data;
+			std::vector<u8> encoded;
+			Common::Timer timer;
+			if (!SaveState_EncodeScreenshot(&copy, codec, &encoded))
+			{
+				Console.Error("(SaveState) %s thumbnail encode failed.", name);
+				return;
+			}
+
+			best_encode_ms = std::min(best_encode_ms, timer.GetTimeMilliseconds());
+			encoded_size = encoded.size();
+
+			// Read it back, to make sure the reader copes with what was written.
+			u32 width, height;
+			std::vector<u32> pixels;
+			timer.Reset();
+			if (!SaveState_DecodeScreenshot(encoded, &width, &height, &pixels) || width != copy.width ||
+				height != copy.height || pixels != copy.pixels)
+			{
+				Console.Error("(SaveState) %s thumbnail doesn't read back the way it was written.", name);
+				return;
+			}
+
+			best_decode_ms = std::min(best_decode_ms, timer.GetTimeMilliseconds());
+		}
+
+		Console.WriteLn("  %s: %.2f ms encode, %.2f ms decode (%zu bytes)", name, best_encode_ms, best_decode_ms, encoded_size);
+	}
+}
+
+// --------------------------------------------------------------------------------------
+//  Parallel zstd compression
+// --------------------------------------------------------------------------------------
+// libzip compresses every entry serially on one thread inside zip_close(). Instead, each
+// entry is compressed up front on the worker pool, and the finished zstd stream is handed
+// to libzip as already-compressed data so it is copied into the archive as-is. Entries
+// bigger than a chunk (EE RAM, GS VRAM) are split into independent zstd frames, which the
+// zstd decoder in libzip reads back as one continuous stream.
+
+static constexpr size_t SaveStateCompressChunkSize = 2 * _1mb;
+
+struct PrecompressedZipEntry
+{
+	const u8* src;
+	size_t src_size;
+	std::vector<std::vector<u8>> chunks;
+	std::vector<u32> chunk_crcs;
+
+	std::vector<u8> data;
+	size_t read_pos = 0;
+	u32 crc = 0;
+	zip_error_t error = {};
+};
+
+static zip_int64_t SaveState_PrecompressedSourceCallback(void* userdata, void* data, zip_uint64_t len, zip_source_cmd_t cmd)
+{
+	PrecompressedZipEntry* entry = static_cast<PrecompressedZipEntry*>(userdata);
+	switch (cmd)
+	{
+		case ZIP_SOURCE_OPEN:
+			entry->read_pos = 0;
+			return 0;
+
+		case ZIP_SOURCE_READ:
+		{
+			const size_t count = std::min<size_t>(len, entry->data.size() - entry->read_pos);
+			std::memcpy(data, entry->data.data() + entry->read_pos, count);
+			entry->read_pos += count;
+			return static_cast<zip_int64_t>(count);
+		}
+
+		case ZIP_SOURCE_CLOSE:
+			return 0;
+
+		case ZIP_SOURCE_STAT:
+		{
+			// Reporting a compression method tells libzip the data is already compressed,
+			// so it is neither recompressed nor re-checksummed.
+			zip_stat_t* st = static_cast<zip_stat_t*>(data);
+			zip_stat_init(st);
+			st->valid = ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_COMP_METHOD | ZIP_STAT_CRC;
+			st->size = entry->src_size;
+			st->comp_size = entry->data.size();
+			st->comp_method = ZIP_CM_ZSTD;
+			st->crc = entry->crc;
+			return sizeof(*st);
+		}
+
+		case ZIP_SOURCE_ERROR:
+			return zip_error_to_data(&entry->error, data, len);
+
+		case ZIP_SOURCE_FREE:
+			delete entry;
+			return 0;
+
+		case ZIP_SOURCE_SUPPORTS:
+			return zip_source_make_command_bitmap(ZIP_SOURCE_OPEN, ZIP_SOURCE_READ, ZIP_SOURCE_CLOSE,
+				ZIP_SOURCE_STAT, ZIP_SOURCE_ERROR, ZIP_SOURCE_FREE, -1);
+
+		default:
+			zip_error_set(&entry->error, ZIP_ER_OPNOTSUPP, 0);
+			return -1;
+	}
+}
+
+static bool SaveState_AddPrecompressedToZip(zip_t* zf, const std::vector<SaveStateEntryData>& entries, WorkerPool& pool)
+{
+	struct ChunkJob
+	{
+		PrecompressedZipEntry* entry;
+		u32 chunk;
+	};
+
+	std::vector<std::unique_ptr<PrecompressedZipEntry>> compressed(entries.size());
+	std::vector<ChunkJob> jobs;
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		compressed[i] = std::make_unique<PrecompressedZipEntry>();
+		compressed[i]->src = entries[i].data;
+		compressed[i]->src_size = entries[i].size;
+
+		const u32 num_chunks = static_cast<u32>((entries[i].size + SaveStateCompressChunkSize - 1) / SaveStateCompressChunkSize);
+		compressed[i]->chunks.resize(num_chunks);
+		compressed[i]->chunk_crcs.resize(num_chunks);
+		for (u32 chunk = 0; chunk < num_chunks; chunk++)
+			jobs.push_back({compressed[i].get(), chunk});
+	}
+
+	std::atomic<bool> failed{false};
+	pool.ParallelFor(static_cast<u32>(jobs.size()), [&jobs, &failed](u32 index) {
+		PrecompressedZipEntry* entry = jobs[index].entry;
+		const u32 chunk = jobs[index].chunk;
+		const size_t offset = chunk * SaveStateCompressChunkSize;
+		const size_t size = std::min(SaveStateCompressChunkSize, entry->src_size - offset);
+		const u8* src = entry->src + offset;
+
+		std::vector<u8>& out = entry->chunks[chunk];
+		out.resize(ZSTD_compressBound(size));
+		const size_t compressed_size = ZSTD_compress(out.data(), out.size(), src, size, ZSTD_CLEVEL_DEFAULT);
+		if (ZSTD_isError(compressed_size))
+		{
+			failed.store(true, std::memory_order_relaxed);
+			return;
+		}
+
+		out.resize(compressed_size);
+		entry->chunk_crcs[chunk] = static_cast<u32>(crc32(0, src, static_cast<uInt>(size)));
+	});
+
+	if (failed.load())
+		return false;
+
+	for (size_t i = 0; i < entries.size(); ++i)
+	{
+		// Stitch the frames together and fold the chunk checksums into one for the whole entry.
+		PrecompressedZipEntry* entry = compressed[i].get();
+		size_t total_size = 0;
+		for (const std::vector<u8>& chunk : entry->chunks)
+			total_size += chunk.size();
+
+		entry->data.reserve(total_size);
+		for (u32 chunk = 0; chunk < entry->chunks.size(); chunk++)
+		{
+			const size_t chunk_src_size = std::min(SaveStateCompressChunkSize, entry->src_size - chunk * SaveStateCompressChunkSize);
+			entry->data.insert(entry->data.end(), entry->chunks[chunk].begin(), entry->chunks[chunk].end());
+			entry->crc = (chunk == 0) ? entry->chunk_crcs[0] :
+				static_cast<u32>(crc32_combine(entry->crc, entry->chunk_crcs[chunk], static_cast<z_off_t>(chunk_src_size)));
+		}
+		entry->chunks = {};
+		zip_error_init(&entry->error);
+
+		zip_source_t* const zs = zip_source_function(zf, SaveState_PrecompressedSourceCallback, entry);
+		if (!zs)
+			return false;
+
+		// Source owns the entry from here on, and frees it on ZIP_SOURCE_FREE.
+		compressed[i].release();
+
+		const s64 fi = zip_file_add(zf, entries[i].name.c_str(), zs, ZIP_FL_ENC_UTF_8);
+		if (fi < 0)
+		{
+			zip_source_free(zs);
+			return false;
+		}
+
+		zip_set_file_compression(zf, fi, ZIP_CM_ZSTD, 0);
+	}
+
+	return true;
+}
+
+static bool SaveState_AddBuffersToZip(zip_t* zf, const std::vector<SaveStateEntryData>& entries, s32 method)
+{
+	for (const SaveStateEntryData& entry : entries)
+	{
+		// The data outlives the archive handle, so libzip can read it in place.
+		zip_source_t* const zs = zip_source_buffer(zf, entry.data, entry.size, 0);
+		if (!zs)
+			return false;
+
+		const s64 fi = zip_file_add(zf, entry.name.c_str(), zs, ZIP_FL_ENC_UTF_8);
+		if (fi < 0)
+		{
+			zip_source_free(zs);
+			return false;
+		}
+
+		zip_set_file_compression(zf, fi, method, 0);
+	}
+
+	return true;
+}
+
+// --------------------------------------------------------------------------------------
+//  Archive writer
+// --------------------------------------------------------------------------------------
+
+static bool SaveState_AddToZip(zip_t* zf, const std::vector<SaveStateEntryData>& entries, SaveStateScreenshotData* screenshot,
+	SaveStateCompression compression, WorkerPool& pool)
+{
+	// Encode the thumbnail on the pool while the state itself is compressed.
+	const SaveStateThumbnailCodec thumbnail_codec = SaveState_GetThumbnailCodec();
+	std::vector<u8> encoded_screenshot;
+	std::future<bool> screenshot_encoded;
+	if (screenshot)
+	{
+		auto task = std::make_shared<std::packaged_task<bool()>>([screenshot, thumbnail_codec, &encoded_screenshot]() {
+			return SaveState_EncodeScreenshot(screenshot, thumbnail_codec, &encoded_screenshot);
+		});
+		screenshot_encoded = task->get_future();
+		pool.Submit([task]() { (*task)(); });
+	}
+
+	// The task writes to our locals, so it must be done before we return, even on failure.
+	ScopedGuard wait_for_screenshot([&screenshot_encoded]() {
+		if (screenshot_encoded.valid())
+			screenshot_encoded.wait();
+	});
+
+	// version indicator
+	{
+		zip_source_t* const zs = zip_source_buffer(zf, &g_SaveVersion, sizeof(g_SaveVersion), 0);
+		if (!zs)
+			return false;
+
+		// NOTE: Source should not be freed if successful.
+		const s64 fi = zip_file_add(zf, EntryFilename_StateVersion, zs, ZIP_FL_ENC_UTF_8);
+		if (fi < 0)
+		{
+			zip_source_free(zs);
+			return false;
+		}
+
+		zip_set_file_compression(zf, fi, ZIP_CM_STORE, 0);
+	}
+
+	// Deflate is left to libzip, which compresses serially in zip_close(), like upstream does.
+	const bool added = (compression == SaveStateCompression::Zstd) ?
+		SaveState_AddPrecompressedToZip(zf, entries, pool) :
+		SaveState_AddBuffersToZip(zf, entries, (compression == SaveStateCompression::Deflate) ? ZIP_CM_DEFLATE : ZIP_CM_STORE);
+	if (!added)
+		return false;
+
+	if (screenshot && (!screenshot_encoded.get() || !SaveState_AddScreenshotToZip(zf, encoded_screenshot, thumbnail_codec)))
+		return false;
+
+	return true;
+}
+
+SaveStateCompression SaveState_GetCompression()
+{
+	return EmuConfig.SavestateZstdCompression ? SaveStateCompression::Zstd : SaveStateCompression::Deflate;
+}
+
+bool SaveState_WriteArchive(const std::vector<SaveStateEntryData>& entries, SaveStateScreenshotData* screenshot,
+	const char* filename, SaveStateCompression compression, Error* error)
+{
+	// libzip writes to a temporary file and renames it over the target in zip_close(), so a
+	// failed save never leaves a half-written state behind.
+	zip_error_t ze = {};
+	zip_source_t* zs = zip_source_file_create(filename, 0, 0, &ze);
+	zip_t* zf = zs ? zip_open_from_source(zs, ZIP_CREATE | ZIP_TRUNCATE, &ze) : nullptr;
+	if (!zf)
+	{
+		Error::SetStringFmt(error, "Failed to create '{}': {}", filename, zip_error_strerror(&ze));
+		if (zs)
+			zip_source_free(zs);
+		return false;
+	}
+
+	// discard zip file if we fail saving something
+	if (!SaveState_AddToZip(zf, entries, screenshot, compression, WorkerPool::GetShared()))
+	{
+		Error::SetStringFmt(error, "Failed to compress the state for '{}'", filename);
+		zip_discard(zf);
+		return false;
+	}
+
+	// force the zip to close, this is the expensive part with libzip.
+	if (zip_close(zf) != 0)
+	{
+		Error::SetStringFmt(error, "Failed to write '{}': {}", filename, zip_strerror(zf));
+		zip_discard(zf);
+		return false;
+	}
+
+	return true;
+}
+
+void SaveState_BenchmarkCompression(const std::vector<SaveStateEntryData>& entries)
+{
+	static constexpr u32 thread_counts[] = {1, 2, 4, 8};
+	static constexpr u32 iterations = 5;
+
+	size_t state_size = 0;
+	for (const SaveStateEntryData& entry : entries)
+		state_size += entry.size;
+
+	Console.WriteLn("(SaveState) zstd compression benchmark, %zu bytes of state, best of %u runs:", state_size, iterations);
+	for (const u32 num_threads : thread_counts)
+	{
+		WorkerPool pool(num_threads);
+		double best_ms = std::numeric_limits<double>::max();
+		size_t archive_size = 0;
+
+		for (u32 i = 0; i < iterations; i++)
+		{
+			Common::Timer timer;
+
+			// Write to memory so the disk doesn't skew the numbers.
+			zip_error_t ze = {};
+			zip_source_t* zs = zip_source_buffer_create(nullptr, 0, 0, &ze);
+			zip_t* zf = zs ? zip_open_from_source(zs, ZIP_TRUNCATE, &ze) : nullptr;
+			if (!zf)
+			{
+				if (zs)
+					zip_source_free(zs);
+				Console.Error("(SaveState) Failed to create in-memory zip for benchmark: %s", zip_error_strerror(&ze));
+				return;
+			}
+
+			// Keep the source alive past zip_close() so we can see how big the archive was.
+			zip_source_keep(zs);
+			bool result = SaveState_AddPrecompressedToZip(zf, entries, pool);
+			if (result)
+				result = (zip_close(zf) == 0);
+			if (!result)
+				zip_discard(zf);
+
+			best_ms = std::min(best_ms, timer.GetTimeMilliseconds());
+
+			zip_stat_t st;
+			if (result && zip_source_stat(zs, &st) == 0)
+				archive_size = st.size;
+			zip_source_free(zs);
+
+			if (!result)
+			{
+				Console.Error("(SaveState) Benchmark save failed with %u threads.", num_threads);
+				return;
+			}
+		}
+
+		Console.WriteLn("  %u thread(s): %.2f ms (%zu bytes)", num_threads, best_ms, archive_size);
+	}
+}
+
+void SaveState_RunBenchmarksFromEnvironment(const std::vector<SaveStateEntryData>& entries, const SaveStateScreenshotData* screenshot)
+{
+	const char* env = std::getenv("OE_SAVESTATE_BENCHMARK");
+	if (env && std::strcmp(env, "1") == 0)
+		SaveState_BenchmarkCompression(entries);
+
+	env = std::getenv("OE_SAVESTATE_THUMBNAIL_BENCHMARK");
+	if (env && std::strcmp(env, "1") == 0 && screenshot)
+		SaveState_BenchmarkThumbnailEncoders(*screenshot);
+}
+
+bool SaveState_SyncFileToDisk(const char* filename)
+{
+	const int fd = open(filename, O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	// fsync() only reaches the drive's cache on macOS.
+	const bool result = (fcntl(fd, F_FULLFSYNC) == 0 || fsync(fd) == 0);
+	close(fd);
+	return result;
+}
+
+// --------------------------------------------------------------------------------------
+//  Incremental savestates
+// --------------------------------------------------------------------------------------
+// An incremental save is split over two files. The base is a complete state, written to
+// "<Cache>/IncrementalSaves/<key>.<id>.base" with the hashes of every page of its large
+// entries stored alongside. The save itself holds the small entries in full, a
+// "<entry>.delta" with only the 4KB pages that differ from the base for each large one, and
+// the id and file name of the base it was written against. Since both archives carry the id,
+// a save always finds its own base, also after a restart, and one whose base is missing or
+// was replaced is reported instead of being patched onto the wrong data. Once more than half
+// the pages differ from the base, the next save writes a new base instead.
+//
+// Bases are shared by all saves made with the same key. Every base has a "<base>.refs" text
+// file next to it, listing the saves written against it. After each incremental save, bases
+// that none of their listed saves point at any more are deleted, along with their list. That
+// is what happens to the previous base once the saves made against it have been overwritten
+// or deleted. The newest base for each key is always kept, it is the one the next save uses.
+//
+// Base reference layout: u64 id, then the base's file name.
+// Hash entry layout: u64 id, then for each large entry: u32 name length, the name, u32 page
+// count and a u64 XXH64 hash per page.
+// Delta entry layout: u32 page count, u32 page index[count], then the page data in the same
+// order (the last page of an entry may be short).
+
+static constexpr const char* EntryFilename_IncrementalBase = "IncrementalBase.bin";
+static constexpr const char* EntryFilename_IncrementalHashes = "IncrementalHashes.bin";
+static constexpr std::string_view IncrementalDeltaSuffix = ".delta";
+static constexpr u32 IncrementalPageSize = 4096;
+static constexpr size_t IncrementalMinEntrySize = 64 * 1024; ///< Smaller entries are always stored in full.
+static constexpr u32 IncrementalPagesPerHashJob = 256;
+
+using IncrementalPageHashes = std::unordered_map<std::string, std::vector<u64>>;
+
+struct IncrementalSaveBase
+{
+	u64 id;
+	std::string filename; ///< Without the directory.
+	IncrementalPageHashes page_hashes;
+};
+
+static std::mutex s_incremental_bases_mutex;
+static std::unordered_map<std::string, IncrementalSaveBase> s_incremental_bases; ///< Newest base for each key.
+
+static std::string SaveState_GetIncrementalDirectory()
+{
+	return Path::Combine(EmuFolders::Cache, "IncrementalSaves");
+}
+
+static u32 SaveState_GetIncrementalPageCount(size_t size)
+{
+	return static_cast<u32>((size + IncrementalPageSize - 1) / IncrementalPageSize);
+}
+
+static bool SaveState_IsIncrementalEntry(const SaveStateEntryData& entry)
+{
+	return entry.size >= IncrementalMinEntrySize;
+}
+
+template <typename T>
+static void SaveState_AppendBytes(std::vector<u8>* out, const T* data, size_t count = 1)
+{
+	const u8* bytes = reinterpret_cast<const u8*>(data);
+	out->insert(out->end(), bytes, bytes + count * sizeof(T));
+}
+
+/// Reads a \p T from \p in at \p pos and advances it. Returns false if there isn't enough data.
+template <typename T>
+static bool SaveState_ReadBytes(const std::vector<u8>& in, size_t* pos, T* data, size_t count = 1)
+{
+	if (count > (in.size() - *pos) / sizeof(T))
+		return false;
+
+	std::memcpy(data, in.data() + *pos, count * sizeof(T));
+	*pos += count * sizeof(T);
+	return true;
+}
+
+static std::optional<std::vector<u8>> SaveState_ReadZipEntry(zip_t* zf, const char* name)
+{
+	auto zff = zip_fopen_managed(zf, name, 0);
+	return zff ? ReadBinaryFileInZip(zff.get()) : std::nullopt;
+}
+
+static IncrementalPageHashes SaveState_HashIncrementalPages(const std::vector<SaveStateEntryData>& entries, u32* total_pages)
+{
+	IncrementalPageHashes hashes;
+	std::vector<std::pair<const SaveStateEntryData*, u32>> jobs;
+	*total_pages = 0;
+	for (const SaveStateEntryData& entry : entries)
+	{
+		if (!SaveState_IsIncrementalEntry(entry))
+			continue;
+
+		const u32 pages = SaveState_GetIncrementalPageCount(entry.size);
+		hashes[entry.name].resize(pages);
+		*total_pages += pages;
+		for (u32 page = 0; page < pages; page += IncrementalPagesPerHashJob)
+			jobs.emplace_back(&entry, page);
+	}
+
+	WorkerPool::GetShared().ParallelFor(static_cast<u32>(jobs.size()), [&jobs, &hashes](u32 index) {
+		const auto [entry, first_page] = jobs[index];
+		std::vector<u64>& entry_hashes = hashes.find(entry->name)->second;
+		const u32 last_page = std::min<u32>(first_page + IncrementalPagesPerHashJob, static_cast<u32>(entry_hashes.size()));
+		for (u32 page = first_page; page < last_page; page++)
+		{
+			const size_t offset = static_cast<size_t>(page) * IncrementalPageSize;
+			entry_hashes[page] = XXH64(entry->data + offset, std::min<size_t>(IncrementalPageSize, entry->size - offset), 0);
+		}
+	});
+
+	return hashes;
+}
+
+static std::vector<u8> SaveState_SerializeIncrementalHashes(const IncrementalSaveBase& base)
+{
+	std::vector<u8> data;
+	SaveState_AppendBytes(&data, &base.id);
+	for (const auto& [name, hashes] : base.page_hashes)
+	{
+		const u32 name_length = static_cast<u32>(name.size());
+		const u32 page_count = static_cast<u32>(hashes.size());
+		SaveState_AppendBytes(&data, &name_length);
+		SaveState_AppendBytes(&data, name.data(), name_length);
+		SaveState_AppendBytes(&data, &page_count);
+		SaveState_AppendBytes(&data, hashes.data(), page_count);
+	}
+
+	return data;
+}
+
+/// Reads the id and page hashes back from the base state at \p path.
+static bool SaveState_ReadIncrementalBase(const std::string& path, IncrementalSaveBase* base)
+{
+	zip_error_t ze = {};
+	auto zf = zip_open_managed(path.c_str(), ZIP_RDONLY, &ze);
+	if (!zf)
+		return false;
+
+	const std::optional<std::vector<u8>> data = SaveState_ReadZipEntry(zf.get(), EntryFilename_IncrementalHashes);
+	size_t pos = 0;
+	if (!data || !SaveState_ReadBytes(*data, &pos, &base->id))
+		return false;
+
+	base->filename = std::string(Path::GetFileName(path));
+	base->page_hashes.clear();
+	while (pos < data->size())
+	{
+		u32 name_length, page_count;
+		std::string name;
+		if (!SaveState_ReadBytes(*data, &pos, &name_length))
+			return false;
+
+		name.resize(name_length);
+		if (!SaveState_ReadBytes(*data, &pos, name.data(), name_length) || !SaveState_ReadBytes(*data, &pos, &page_count))
+			return false;
+
+		std::vector<u64>& hashes = base->page_hashes[name];
+		hashes.resize(page_count);
+		if (!SaveState_ReadBytes(*data, &pos, hashes.data(), page_count))
+			return false;
+	}
+
+	return true;
+}
+
+/// Finds the newest base written for \p key, e.g. by an earlier run.
+static bool SaveState_FindIncrementalBase(const std::string& key, IncrementalSaveBase* base)
+{
+	FileSystem::FindResultsArray results;
+	FileSystem::FindFiles(SaveState_GetIncrementalDirectory().c_str(), fmt::format("{}.*.base", key).c_str(),
+		FILESYSTEM_FIND_FILES, &results);
+
+	const FILESYSTEM_FIND_DATA* newest = nullptr;
+	for (const FILESYSTEM_FIND_DATA& fd : results)
+	{
+		if (!newest || fd.ModificationTime > newest->ModificationTime)
+			newest = &fd;
+	}
+
+	return newest && SaveState_ReadIncrementalBase(newest->FileName, base);
+}
+
+static bool SaveState_ReadIncrementalReference(zip_t* zf, u64* id, std::string* base_filename)
+{
+	const std::optional<std::vector<u8>> data = SaveState_ReadZipEntry(zf, EntryFilename_IncrementalBase);
+	size_t pos = 0;
+	if (!data || !SaveState_ReadBytes(*data, &pos, id))
+		return false;
+
+	base_filename->assign(reinterpret_cast<const char*>(data->data() + pos), data->size() - pos);
+
+	// Only ever a file name, never a path out of the incremental folder.
+	return !base_filename->empty() && Path::GetFileName(*base_filename) == *base_filename;
+}
+
+/// Adds \p save_filename to the list of saves written against \p base_filename.
+static bool SaveState_AddIncrementalReference(const std::string& base_filename, const char* save_filename, Error* error)
+{
+	const std::string refs_path = Path::Combine(SaveState_GetIncrementalDirectory(), base_filename + ".refs");
+	std::string refs = FileSystem::ReadFileToString(refs_path.c_str()).value_or(std::string());
+	for (const std::string_view line : StringUtil::SplitString(refs, '\n'))
+	{
+		if (line == save_filename)
+			return true;
+	}
+
+	refs += save_filename;
+	refs += '\n';
+	return FileSystem::WriteStringToFile(refs_path.c_str(), refs, error);
+}
+
+/// Returns true if the save at \p save_filename was written against \p base.
+static bool SaveState_IsIncrementalReference(const std::string& save_filename, u64 base_id, const std::string& base_filename)
+{
+	zip_error_t ze = {};
+	auto zf = zip_open_managed(save_filename.c_str(), ZIP_RDONLY, &ze);
+	u64 id;
+	std::string filename;
+	return zf && SaveState_ReadIncrementalReference(zf.get(), &id, &filename) && id == base_id && filename == base_filename;
+}
+
+/// Deletes the bases that no save points at any more. Called with s_incremental_bases_mutex held.
+static void SaveState_PruneIncrementalBases()
+{
+	const std::string directory = SaveState_GetIncrementalDirectory();
+	FileSystem::FindResultsArray results;
+	FileSystem::FindFiles(directory.c_str(), "*.base", FILESYSTEM_FIND_FILES, &results);
+	for (const FILESYSTEM_FIND_DATA& fd : results)
+	{
+		const std::string base_filename(Path::GetFileName(fd.FileName));
+		const bool newest = std::any_of(s_incremental_bases.begin(), s_incremental_bases.end(),
+			[&base_filename](const auto& it) { return it.second.filename == base_filename; });
+		if (newest)
+			continue;
+
+		// The id is part of the file name, so there's no need to open the base for it.
+		const std::string_view name(base_filename);
+		const size_t id_end = name.size() - std::string_view(".base").size();
+		const size_t id_start = name.rfind('.', id_end - 1);
+		const std::optional<u64> id = (id_start == std::string_view::npos) ? std::nullopt :
+			StringUtil::FromChars<u64>(name.substr(id_start + 1, id_end - id_start - 1), 16);
+		if (!id.has_value())
+			continue;
+
+		// Bases without a list predate it, there's no telling which saves use them.
+		const std::string refs_path = fd.FileName + ".refs";
+		const std::optional<std::string> refs = FileSystem::ReadFileToString(refs_path.c_str());
+		if (!refs.has_value())
+			continue;
+
+		std::string live_refs;
+		for (const std::string_view line : StringUtil::SplitString(refs.value(), '\n'))
+		{
+			const std::string save_filename(line);
+			if (!save_filename.empty() && SaveState_IsIncrementalReference(save_filename, id.value(), base_filename))
+			{
+				live_refs += save_filename;
+				live_refs += '\n';
+			}
+		}
+
+		if (live_refs.empty())
+		{
+			DevCon.WriteLn("(SaveState) Deleting incremental base '%s', no save uses it any more.", base_filename.c_str());
+			FileSystem::DeleteFilePath(fd.FileName.c_str());
+			FileSystem::DeleteFilePath(refs_path.c_str());
+		}
+		else if (live_refs != refs.value())
+		{
+			FileSystem::WriteStringToFile(refs_path.c_str(), live_refs);
+		}
+	}
+}
+
+static bool SaveState_WriteIncrementalBase(const std::vector<SaveStateEntryData>& entries, const std::string& key,
+	IncrementalPageHashes hashes, IncrementalSaveBase* base, Error* error)
+{
+	std::random_device rd;
+	base->id = (static_cast<u64>(rd()) << 32) | rd();
+	base->filename = fmt::format("{}.{:016x}.base", key, base->id);
+	base->page_hashes = std::move(hashes);
+
+	const std::string directory = SaveState_GetIncrementalDirectory();
+	if (!FileSystem::EnsureDirectoryExists(directory.c_str(), false, error))
+		return false;
+
+	const std::vector<u8> hash_data = SaveState_SerializeIncrementalHashes(*base);
+	std::vector<SaveStateEntryData> base_entries(entries);
+	base_entries.push_back({EntryFilename_IncrementalHashes, hash_data.data(), hash_data.size()});
+
+	// The base has to be on disk before any save that depends on it.
+	const std::string path = Path::Combine(directory, base->filename);
+	if (!SaveState_WriteArchive(base_entries, nullptr, path.c_str(), SaveState_GetCompression(), error))
+		return false;
+
+	if (!SaveState_SyncFileToDisk(path.c_str()))
+	{
+		Error::SetErrno(error, fmt::format("Failed to flush '{}': ", path), errno);
+		return false;
+	}
+
+	return true;
+}
+
+bool SaveState_WriteIncremental(const std::vector<SaveStateEntryData>& entries, SaveStateScreenshotData* screenshot,
+	const char* filename, const std::string& key, Error* error)
+{
+	const std::string safe_key = Path::SanitizeFileName(key.empty() ? std::string("Unknown") : key);
+	u32 total_pages;
+	IncrementalPageHashes hashes = SaveState_HashIncrementalPages(entries, &total_pages);
+
+	std::unique_lock lock(s_incremental_bases_mutex);
+
+	// After a restart the base from the last run is picked up again.
+	auto it = s_incremental_bases.find(safe_key);
+	if (it == s_incremental_bases.end())
+	{
+		IncrementalSaveBase base;
+		if (SaveState_FindIncrementalBase(safe_key, &base))
+			it = s_incremental_bases.emplace(safe_key, std::move(base)).first;
+	}
+
+	// Work out what changed since the base, if there's a base we can still use.
+	std::unordered_map<std::string, std::vector<u32>> changed;
+	u32 changed_pages = 0;
+	bool rebase = (it == s_incremental_bases.end() ||
+				   !FileSystem::FileExists(Path::Combine(SaveState_GetIncrementalDirectory(), it->second.filename).c_str()) ||
+				   it->second.page_hashes.size() != hashes.size());
+	for (auto hash_it = hashes.begin(); !rebase && hash_it != hashes.end(); ++hash_it)
+	{
+		const auto base_it = it->second.page_hashes.find(hash_it->first);
+		if (base_it == it->second.page_hashes.end() || base_it->second.size() != hash_it->second.size())
+		{
+			rebase = true;
+			break;
+		}
+
+		std::vector<u32>& pages = changed[hash_it->first];
+		for (u32 page = 0; page < hash_it->second.size(); page++)
+		{
+			if (hash_it->second[page] != base_it->second[page])
+				pages.push_back(page);
+		}
+
+		changed_pages += static_cast<u32>(pages.size());
+	}
+
+	if (rebase || changed_pages > total_pages / 2)
+	{
+		IncrementalSaveBase base;
+		if (!SaveState_WriteIncrementalBase(entries, safe_key, std::move(hashes), &base, error))
+		{
+			s_incremental_bases.erase(safe_key);
+			return false;
+		}
+
+		it = s_incremental_bases.insert_or_assign(safe_key, std::move(base)).first;
+		changed.clear();
+		changed_pages = 0;
+	}
+
+	// Small entries go in as-is, large ones as deltas against the base.
+	std::vector<std::vector<u8>> deltas;
+	std::vector<SaveStateEntryData> delta_entries;
+	deltas.reserve(entries.size());
+	for (const SaveStateEntryData& entry : entries)
+	{
+		if (!SaveState_IsIncrementalEntry(entry))
+		{
+			delta_entries.push_back(entry);
+			continue;
+		}
+
+		const std::vector<u32>& pages = changed[entry.name];
+		const u32 count = static_cast<u32>(pages.size());
+		std::vector<u8>& delta = deltas.emplace_back();
+		SaveState_AppendBytes(&delta, &count);
+		SaveState_AppendBytes(&delta, pages.data(), count);
+		for (const u32 page : pages)
+		{
+			const size_t offset = static_cast<size_t>(page) * IncrementalPageSize;
+			SaveState_AppendBytes(&delta, entry.data + offset, std::min<size_t>(IncrementalPageSize, entry.size - offset));
+		}
+
+		delta_entries.push_back({entry.name + std::string(IncrementalDeltaSuffix), delta.data(), delta.size()});
+	}
+
+	std::vector<u8> reference;
+	SaveState_AppendBytes(&reference, &it->second.id);
+	SaveState_AppendBytes(&reference, it->second.filename.data(), it->second.filename.size());
+	delta_entries.push_back({EntryFilename_IncrementalBase, reference.data(), reference.size()});
+
+	// Listed before the save is written, so the base can't be pruned out from under it.
+	if (!SaveState_AddIncrementalReference(it->second.filename, filename, error))
+		return false;
+
+	DevCon.WriteLn("(SaveState) Incremental save to '%s': %u of %u memory pages changed.", filename, changed_pages, total_pages);
+	if (!SaveState_WriteArchive(delta_entries, screenshot, filename, SaveState_GetCompression(), error))
+		return false;
+
+	SaveState_PruneIncrementalBases();
+	return true;
+}
+
+static bool SaveState_ApplyIncrementalDelta(const std::vector<u8>& delta, std::vector<u8>* data)
+{
+	u32 count;
+	size_t pos = 0;
+	std::vector<u32> pages;
+	if (!SaveState_ReadBytes(delta, &pos, &count))
+		return false;
+
+	pages.resize(count);
+	if (!SaveState_ReadBytes(delta, &pos, pages.data(), count))
+		return false;
+
+	for (const u32 page : pages)
+	{
+		if (page >= SaveState_GetIncrementalPageCount(data->size()))
+			return false;
+
+		const size_t offset = static_cast<size_t>(page) * IncrementalPageSize;
+		if (!SaveState_ReadBytes(delta, &pos, data->data() + offset, std::min<size_t>(IncrementalPageSize, data->size() - offset)))
+			return false;
+	}
+
+	return (pos == delta.size());
+}
+
+/// Puts the incremental save \p zf back together with its base, into \p names and \p data.
+static bool SaveState_RebuildIncremental(zip_t* zf, const char* filename, std::vector<std::string>* names,
+	std::vector<std::vector<u8>>* data, Error* error)
+{
+	zip_error_t ze = {};
+	u64 id;
+	std::string base_filename;
+	if (!SaveState_ReadIncrementalReference(zf, &id, &base_filename))
+	{
+		Error::SetStringFmt(error, "'{}' has no valid base reference.", filename);
+		return false;
+	}
+
+	const std::string base_path = Path::Combine(SaveState_GetIncrementalDirectory(), base_filename);
+	auto bzf = zip_open_managed(base_path.c_str(), ZIP_RDONLY, &ze);
+	if (!bzf)
+	{
+		Error::SetStringFmt(error, "The base state '{}' for '{}' is missing: {}", base_path, filename, zip_error_strerror(&ze));
+		return false;
+	}
+
+	const std::optional<std::vector<u8>> base_hashes = SaveState_ReadZipEntry(bzf.get(), EntryFilename_IncrementalHashes);
+	u64 base_id;
+	size_t pos = 0;
+	if (!base_hashes || !SaveState_ReadBytes(*base_hashes, &pos, &base_id) || base_id != id)
+	{
+		Error::SetStringFmt(error, "'{}' was not saved against '{}'.", filename, base_path);
+		return false;
+	}
+
+	const zip_int64_t num_entries = zip_get_num_entries(zf, 0);
+	for (zip_int64_t i = 0; i < num_entries; i++)
+	{
+		const char* name = zip_get_name(zf, static_cast<zip_uint64_t>(i), 0);
+		if (!name || std::strcmp(name, EntryFilename_Screenshot) == 0 || std::strcmp(name, EntryFilename_ScreenshotWebP) == 0 ||
+			std::strcmp(name, EntryFilename_IncrementalBase) == 0)
+		{
+			continue;
+		}
+
+		auto zff = zip_fopen_index_managed(zf, static_cast<zip_uint64_t>(i), 0);
+		std::optional<std::vector<u8>> entry_data = zff ? ReadBinaryFileInZip(zff.get()) : std::nullopt;
+		if (!entry_data)
+		{
+			Error::SetStringFmt(error, "Failed to read '{}' from '{}'.", name, filename);
+			return false;
+		}
+
+		std::string entry_name(name);
+		if (entry_name.ends_with(IncrementalDeltaSuffix))
+		{
+			entry_name.resize(entry_name.size() - IncrementalDeltaSuffix.size());
+			std::optional<std::vector<u8>> base_data = SaveState_ReadZipEntry(bzf.get(), entry_name.c_str());
+			if (!base_data || !SaveState_ApplyIncrementalDelta(*entry_data, &*base_data))
+			{
+				Error::SetStringFmt(error, "Failed to apply the delta for '{}' from '{}'.", entry_name, filename);
+				return false;
+			}
+
+			entry_data = std::move(base_data);
+		}
+
+		data->push_back(std::move(*entry_data));
+		names->push_back(std::move(entry_name));
+	}
+
+	return true;
+}
+
+// --------------------------------------------------------------------------------------
+//  Loading
+// --------------------------------------------------------------------------------------
+// OpenEmu's savestate loader, used in place of VMManager::LoadState(). It restores the same
+// entries in the same order as pcsx2/SaveState.cpp, with the same preparation before and
+// after. The difference is in how the entries are read: the PAD and USB components are
+// parsed straight out of the archive as they are inflated, instead of being inflated into a
+// buffer first, and the memory entries are inflated in parallel, see below. It can also load
+// a state held in memory, for rewind, without writing it out to a file first.
+//
+// The internal structures and the SPU2 and GS states are still read whole, since
+// memLoadingState and the freeze functions want them in one piece.
+
+static constexpr const char* EntryFilename_InternalStructures = "PCSX2 Internal Structures.dat";
+
+static tlbs s_tlb_backup[std::size(tlb)];
+
+/// A plain memory entry, loaded byte for byte. The addresses are only known at runtime.
+struct SaveStateMemoryEntry
+{
+	const char* filename;
+	u8* data;
+	u32 size;
+};
+
+static std::vector<SaveStateMemoryEntry> SaveState_GetMemoryEntries()
+{
+	return {
+		{"eeMemory.bin", eeMem->Main, sizeof(eeMem->Main)},
+		{"iopMemory.bin", iopMem->Main, sizeof(iopMem->Main)},
+		{"eeHwRegs.bin", eeHw, sizeof(eeHw)},
+		{"iopHwRegs.bin", iopHw, sizeof(iopHw)},
+		{"Scratchpad.bin", eeMem->Scratch, sizeof(eeMem->Scratch)},
+		{"vu0Memory.bin", vuRegs[0].Mem, VU0_MEMSIZE},
+		{"vu1Memory.bin", vuRegs[1].Mem, VU1_MEMSIZE},
+		{"vu0MicroMem.bin", vuRegs[0].Micro, VU0_PROGSIZE},
+		{"vu1MicroMem.bin", vuRegs[1].Micro, VU1_PROGSIZE},
+	};
+}
+
+/// Where the loader gets a state's entries from.
+class SaveStateLoadSource
+{
+public:
+	virtual ~SaveStateLoadSource() = default;
+
+	virtual bool HasEntry(const char* name) = 0;
+
+	/// Copies each of \p entries straight into place.
+	virtual bool LoadMemoryEntries(const std::vector<SaveStateMemoryEntry>& entries, Error* error) = 0;
+
+	/// Returns the whole of an entry. The data stays valid until the next call.
+	virtual bool GetEntry(const char* name, std::span<const u8>* data) = 0;
+
+	/// Opens an entry for reading as a stream, or returns null if it is missing.
+	virtual std::unique_ptr<StateWrapper::IStream> OpenEntryStream(const char* name) = 0;
+};
+
+/// Read-only StateWrapper stream that inflates straight out of a zip entry as the component
+/// asks for data. Only forward seeks are supported, since the entry is compressed.
+class SaveStateZipReadStream final : public StateWrapper::IStream
+{
+public:
+	explicit SaveStateZipReadStream(ManagedZipFileT zf)
+		: m_zf(std::move(zf))
+	{
+	}
+
+	u32 Read(void* buf, u32 count) override
+	{
+		const zip_int64_t read = zip_fread(m_zf.get(), buf, count);
+		if (read <= 0)
+			return 0;
+
+		m_pos += static_cast<u32>(read);
+		return static_cast<u32>(read);
+	}
+
+	u32 Write(const void* buf, u32 count) override
+	{
+		return 0;
+	}
+
+	u32 GetPosition() override
+	{
+		return m_pos;
+	}
+
+	bool SeekAbsolute(u32 pos) override
+	{
+		if (pos < m_pos)
+			return false;
+
+		return Skip(pos - m_pos);
+	}
+
+	bool SeekRelative(s32 count) override
+	{
+		if (count < 0)
+			return false;
+
+		return Skip(static_cast<u32>(count));
+	}
+
+private:
+	bool Skip(u32 count)
+	{
+		u8 discard[4096];
+		while (count > 0)
+		{
+			const u32 chunk = std::min<u32>(count, sizeof(discard));
+			if (Read(discard, chunk) != chunk)
+				return false;
+			count -= chunk;
+		}
+
+		return true;
+	}
+
+	ManagedZipFileT m_zf;
+	u32 m_pos = 0;
+};
+
+// --------------------------------------------------------------------------------------
+//  Parallel memory entry loading
+// --------------------------------------------------------------------------------------
+// The plain memory entries (EE/IOP RAM, VU memory, scratchpad...) don't depend on each other
+// or on load order, so they're inflated concurrently straight into their final location.
+// zstd entries written by SaveState_WriteArchive() are made of several independent frames,
+// and each frame is decoded as its own job, so even EE RAM alone is spread across cores. The
+// compressed data is read serially (libzip handles aren't thread safe), and the CRC is
+// checked per job and combined, since we're bypassing libzip's own check.
+
+struct MemoryLoadJob
+{
+	u32 entry;
+	const u8* src;
+	size_t src_size;
+	u8* dst;
+	size_t dst_size;
+	u32 crc;
+};
+
+struct MemoryLoadEntry
+{
+	const SaveStateMemoryEntry* entry;
+	zip_stat_t stat;
+	std::vector<u8> compressed;
+	u32 first_job;
+	u32 num_jobs;
+};
+
+static bool SaveState_InflateDeflateJob(MemoryLoadJob& job)
+{
+	z_stream zs = {};
+	if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+		return false;
+
+	zs.next_in = const_cast<Bytef*>(job.src);
+	zs.avail_in = static_cast<uInt>(job.src_size);
+	zs.next_out = job.dst;
+	zs.avail_out = static_cast<uInt>(job.dst_size);
+	const int ret = inflate(&zs, Z_FINISH);
+	const bool result = (ret == Z_STREAM_END && zs.total_out == job.dst_size);
+	inflateEnd(&zs);
+	return result;
+}
+
+/// Loads every entry it can in parallel and sets \p loaded for those. Anything unusual, like a
+/// short entry, is left for the caller to read serially.
+static bool SaveState_LoadMemoryEntriesParallel(zip_t* zf, const std::vector<SaveStateMemoryEntry>& mem_entries,
+	std::vector<bool>* loaded, WorkerPool& pool, Error* error)
+{
+	static constexpr zip_uint64_t required_stats = ZIP_STAT_SIZE | ZIP_STAT_COMP_SIZE | ZIP_STAT_COMP_METHOD | ZIP_STAT_CRC;
+
+	std::vector<MemoryLoadEntry> entries;
+	std::vector<MemoryLoadJob> jobs;
+	loaded->assign(mem_entries.size(), false);
+
+	for (size_t i = 0; i < mem_entries.size(); ++i)
+	{
+		const SaveStateMemoryEntry& mem_entry = mem_entries[i];
+		const zip_int64_t index = zip_name_locate(zf, mem_entry.filename, 0);
+		MemoryLoadEntry le = {&mem_entry};
+		if (index < 0 || zip_stat_index(zf, index, 0, &le.stat) != 0 ||
+			(le.stat.valid & required_stats) != required_stats || le.stat.size != mem_entry.size)
+		{
+			continue;
+		}
+
+		if (le.stat.comp_method != ZIP_CM_ZSTD && le.stat.comp_method != ZIP_CM_DEFLATE && le.stat.comp_method != ZIP_CM_STORE)
+			continue;
+
+		auto zff = zip_fopen_index_managed(zf, index, ZIP_FL_COMPRESSED);
+		le.compressed.resize(le.stat.comp_size);
+		if (!zff || zip_fread(zff.get(), le.compressed.data(), le.compressed.size()) != static_cast<zip_int64_t>(le.compressed.size()))
+		{
+			Error::SetStringFmt(error, "Failed to read '{}' from the state.", mem_entry.filename);
+			return false;
+		}
+
+		le.first_job = static_cast<u32>(jobs.size());
+		const u32 entry_index = static_cast<u32>(entries.size());
+		bool split = false;
+		if (le.stat.comp_method == ZIP_CM_ZSTD)
+		{
+			// Split on frame boundaries. Every frame we write records its content size, but
+			// states compressed by libzip itself are one frame without it, so those fall back
+			// to a single job for the whole entry.
+			const u8* src = le.compressed.data();
+			size_t src_remaining = le.compressed.size();
+			size_t dst_offset = 0;
+			split = true;
+			while (src_remaining > 0)
+			{
+				const size_t frame_size = ZSTD_findFrameCompressedSize(src, src_remaining);
+				const unsigned long long content_size = ZSTD_getFrameContentSize(src, src_remaining);
+				if (ZSTD_isError(frame_size) || content_size == ZSTD_CONTENTSIZE_UNKNOWN ||
+					content_size == ZSTD_CONTENTSIZE_ERROR || dst_offset + content_size > le.stat.size)
+				{
+					split = false;
+					break;
+				}
+
+				jobs.push_back({entry_index, src, frame_size, mem_entry.data + dst_offset, static_cast<size_t>(content_size), 0});
+				src += frame_size;
+				src_remaining -= frame_size;
+				dst_offset += static_cast<size_t>(content_size);
+			}
+
+			if (!split || dst_offset != le.stat.size)
+			{
+				jobs.resize(le.first_job);
+				split = false;
+			}
+		}
+
+		if (!split)
+			jobs.push_back({entry_index, le.compressed.data(), le.compressed.size(), mem_entry.data, le.stat.size, 0});
+
+		le.num_jobs = static_cast<u32>(jobs.size()) - le.first_job;
+		entries.push_back(std::move(le));
+		(*loaded)[i] = true;
+	}
+
+	std::atomic<bool> failed{false};
+	pool.ParallelFor(static_cast<u32>(jobs.size()), [&entries, &jobs, &failed](u32 index) {
+		MemoryLoadJob& job = jobs[index];
+		bool result;
+		switch (entries[job.entry].stat.comp_method)
+		{
+			case ZIP_CM_ZSTD:
+			{
+				const size_t size = ZSTD_decompress(job.dst, job.dst_size, job.src, job.src_size);
+				result = !ZSTD_isError(size) && size == job.dst_size;
+			}
+			break;
+
+			case ZIP_CM_DEFLATE:
+				result = SaveState_InflateDeflateJob(job);
+				break;
+
+			default:
+				result = (job.src_size == job.dst_size);
+				if (result)
+					std::memcpy(job.dst, job.src, job.dst_size);
+				break;
+		}
+
+		if (!result)
+		{
+			failed.store(true, std::memory_order_relaxed);
+			return;
+		}
+
+		job.crc = static_cast<u32>(crc32(0, job.dst, static_cast<uInt>(job.dst_size)));
+	});
+
+	if (failed.load())
+	{
+		Error::SetString(error, "Failed to decompress the state's memory.");
+		return false;
+	}
+
+	for (const MemoryLoadEntry& le : entries)
+	{
+		u32 crc = jobs[le.first_job].crc;
+		for (u32 i = 1; i < le.num_jobs; i++)
+		{
+			const MemoryLoadJob& job = jobs[le.first_job + i];
+			crc = static_cast<u32>(crc32_combine(crc, job.crc, static_cast<z_off_t>(job.dst_size)));
+		}
+
+		if (crc != le.stat.crc)
+		{
+			Error::SetStringFmt(error, "CRC mismatch in '{}'.", le.entry->filename);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+class SaveStateArchiveSource final : public SaveStateLoadSource
+{
+public:
+	explicit SaveStateArchiveSource(zip_t* zf)
+		: m_zf(zf)
+	{
+	}
+
+	bool HasEntry(const char* name) override
+	{
+		return zip_name_locate(m_zf, name, 0) >= 0;
+	}
+
+	bool LoadMemoryEntries(const std::vector<SaveStateMemoryEntry>& entries, Error* error) override
+	{
+		std::vector<bool> loaded;
+		if (!SaveState_LoadMemoryEntriesParallel(m_zf, entries, &loaded, WorkerPool::GetShared(), error))
+			return false;
+
+		for (size_t i = 0; i < entries.size(); i++)
+		{
+			if (loaded[i])
+				continue;
+
+			const SaveStateMemoryEntry& entry = entries[i];
+			auto zff = zip_fopen_managed(m_zf, entry.filename, 0);
+			const zip_int64_t read = zff ? zip_fread(zff.get(), entry.data, entry.size) : -1;
+			if (read < 0)
+			{
+				Error::SetStringFmt(error, "Failed to read '{}' from the state.", entry.filename);
+				return false;
+			}
+
+			if (read != static_cast<zip_int64_t>(entry.size))
+			{
+				Console.WriteLn(Color_Yellow, " '%s' is incomplete (expected 0x%x bytes, loading only 0x%x bytes)",
+					entry.filename, entry.size, static_cast<u32>(read));
+			}
+		}
+
+		return true;
+	}
+
+	bool GetEntry(const char* name, std::span<const u8>* data) override
+	{
+		std::optional<std::vector<u8>> contents = SaveState_ReadZipEntry(m_zf, name);
+		if (!contents.has_value())
+			return false;
+
+		m_buffer = std::move(contents.value());
+		*data = m_buffer;
+		return true;
+	}
+
+	std::unique_ptr<StateWrapper::IStream> OpenEntryStream(const char* name) override
+	{
+		ManagedZipFileT zff = zip_fopen_managed(m_zf, name, 0);
+		if (!zff)
+			return nullptr;
+
+		return std::make_unique<SaveStateZipReadStream>(std::move(zff));
+	}
+
+private:
+	zip_t* m_zf;
+	std::vector<u8> m_buffer;
+};
+
+class SaveStateMemorySource final : public SaveStateLoadSource
+{
+public:
+	explicit SaveStateMemorySource(const std::vector<SaveStateEntryData>& entries)
+		: m_entries(entries)
+	{
+	}
+
+	bool HasEntry(const char* name) override
+	{
+		return FindEntry(name) != nullptr;
+	}
+
+	bool LoadMemoryEntries(const std::vector<SaveStateMemoryEntry>& entries, Error* error) override
+	{
+		for (const SaveStateMemoryEntry& entry : entries)
+		{
+			const SaveStateEntryData* data = FindEntry(entry.filename);
+			if (!data)
+			{
+				Error::SetStringFmt(error, "The state is missing '{}'.", entry.filename);
+				return false;
+			}
+
+			if (data->size != entry.size)
+			{
+				Console.WriteLn(Color_Yellow, " '%s' is incomplete (expected 0x%x bytes, loading only 0x%x bytes)",
+					entry.filename, entry.size, static_cast<u32>(std::min<size_t>(data->size, entry.size)));
+			}
+
+			std::memcpy(entry.data, data->data, std::min<size_t>(data->size, entry.size));
+		}
+
+		return true;
+	}
+
+	bool GetEntry(const char* name, std::span<const u8>* data) override
+	{
+		const SaveStateEntryData* entry = FindEntry(name);
+		if (!entry)
+		{
+			// Captured states don't carry a version, they are always the current one.
+			if (std::strcmp(name, EntryFilename_StateVersion) != 0)
+				return false;
+
+			*data = std::span<const u8>(reinterpret_cast<const u8*>(&g_SaveVersion), sizeof(g_SaveVersion));
+			return true;
+		}
+
+		*data = std::span<const u8>(entry->data, entry->size);
+		return true;
+	}
+
+	std::unique_ptr<StateWrapper::IStream> OpenEntryStream(const char* name) override
+	{
+		const SaveStateEntryData* entry = FindEntry(name);
+		if (!entry)
+			return nullptr;
+
+		return std::make_unique<StateWrapper::ReadOnlyMemoryStream>(entry->data, static_cast<u32>(entry->size));
+	}
+
+private:
+	const SaveStateEntryData* FindEntry(const char* name) const
+	{
+		for (const SaveStateEntryData& entry : m_entries)
+		{
+			if (entry.name == name)
+				return &entry;
+		}
+
+		return nullptr;
+	}
+
+	const std::vector<SaveStateEntryData>& m_entries;
+};
+
+static void SaveState_PreLoadPrep()
+{
+	// ensure everything is in sync before we start overwriting stuff.
+	if (THREAD_VU1)
+		vu1Thread.WaitVU();
+	MTGS::WaitGS(false);
+
+	// backup current TLBs, since we're going to overwrite them all
+	std::memcpy(s_tlb_backup, tlb, sizeof(s_tlb_backup));
+
+	// clear protected pages, since we don't want to fault loading EE memory
+	mmap_ResetBlockTracking();
+
+	VMManager::Internal::ClearCPUExecutionCaches();
+}
+
+static void SaveState_PostLoadPrep()
+{
+	resetCache();
+	for (u32 i = 0; i < std::size(tlb); i++)
+	{
+		if (std::memcmp(&s_tlb_backup[i], &tlb[i], sizeof(tlbs)) != 0)
+		{
+			UnmapTLB(s_tlb_backup[i], i);
+			MapTLB(tlb[i], i);
+		}
+	}
+
+	if (EmuConfig.Gamefixes.GoemonTlbHack)
+		GoemonPreloadTlb();
+	CBreakPoints::SetSkipFirst(BREAKPOINT_EE, 0);
+	CBreakPoints::SetSkipFirst(BREAKPOINT_IOP, 0);
+
+	UpdateVSyncRate(true);
+}
+
+static int SaveState_FreezeGS(FreezeAction mode, freezeData* fd)
+{
+	MTGS::FreezeData mfd = {fd, 0};
+	MTGS::Freeze(mode, mfd);
+	return mfd.retval;
+}
+
+static bool SaveState_LoadFreezeComponent(SaveStateLoadSource& source, const char* filename,
+	int (*freeze)(FreezeAction, freezeData*), Error* error)
+{
+	std::span<const u8> data;
+	freezeData fd = {0, nullptr};
+	if (!source.GetEntry(filename, &data) || freeze(FreezeAction::Size, &fd) != 0 ||
+		data.size() < static_cast<size_t>(fd.size))
+	{
+		Error::SetStringFmt(error, "'{}' is missing or incomplete.", filename);
+		return false;
+	}
+
+	// Only read from when loading.
+	fd.data = const_cast<u8*>(data.data());
+	if (freeze(FreezeAction::Load, &fd) != 0)
+	{
+		Error::SetStringFmt(error, "Failed to load '{}'.", filename);
+		return false;
+	}
+
+	return true;
+}
+
+static bool SaveState_LoadStreamComponent(SaveStateLoadSource& source, const char* filename,
+	bool (*do_state)(StateWrapper&), Error* error)
+{
+	// A missing optional entry is read as empty, which resets the component, as upstream does.
+	std::unique_ptr<StateWrapper::IStream> stream = source.OpenEntryStream(filename);
+	StateWrapper::ReadOnlyMemoryStream empty(nullptr, 0);
+	StateWrapper sw(stream ? stream.get() : &empty, StateWrapper::Mode::Read, g_SaveVersion);
+	if (!do_state(sw))
+	{
+		Error::SetStringFmt(error, "Failed to load '{}'.", filename);
+		return false;
+	}
+
+	return true;
+}
+
+static bool SaveState_LoadFromSource(SaveStateLoadSource& source, bool* vm_modified, Error* error)
+{
+	std::span<const u8> version_data;
+	u32 version;
+	if (!source.GetEntry(EntryFilename_StateVersion, &version_data) || version_data.size() != sizeof(version))
+	{
+		Error::SetString(error, "This file is not a valid PCSX2 savestate, it has no version.");
+		return false;
+	}
+
+	// Newer states, and ones from another major version, can't be loaded at all.
+	std::memcpy(&version, version_data.data(), sizeof(version));
+	if (version > g_SaveVersion || (version >> 16) != (g_SaveVersion >> 16))
+	{
+		Error::SetStringFmt(error, "The state is an unsupported version. (PCSX2 ver={:x}, state ver={:x})", g_SaveVersion, version);
+		return false;
+	}
+
+	const std::vector<SaveStateMemoryEntry> memory_entries = SaveState_GetMemoryEntries();
+	std::vector<const char*> required = {EntryFilename_InternalStructures, "SPU2.bin", "PAD.bin", "GS.bin"};
+	for (const SaveStateMemoryEntry& entry : memory_entries)
+		required.push_back(entry.filename);
+	for (const char* name : required)
+	{
+		if (!source.HasEntry(name))
+		{
+			Error::SetStringFmt(error, "The state is missing '{}'.", name);
+			return false;
+		}
+	}
+
+	// Nothing has been touched up to here.
+	SaveState_PreLoadPrep();
+	*vm_modified = true;
+
+	std::span<const u8> internals;
+	if (!source.GetEntry(EntryFilename_InternalStructures, &internals))
+	{
+		Error::SetStringFmt(error, "Failed to read '{}'.", EntryFilename_InternalStructures);
+		return false;
+	}
+
+	const VmStateBuffer internals_buffer(internals.begin(), internals.end());
+	memLoadingState state(internals_buffer);
+	if (!state.FreezeBios() || !state.FreezeInternals(error))
+		return false;
+
+	if (!source.LoadMemoryEntries(memory_entries, error))
+		return false;
+
+	// EE RAM was replaced, so anything recompiled from the old contents is stale.
+	VMManager::Internal::ClearCPUExecutionCaches();
+
+	if (!SaveState_LoadFreezeComponent(source, "SPU2.bin", &SPU2freeze, error) ||
+		!SaveState_LoadStreamComponent(source, "USB.bin", &USB::DoState, error) ||
+		!SaveState_LoadStreamComponent(source, "PAD.bin", &Pad::Freeze, error) ||
+		!SaveState_LoadFreezeComponent(source, "GS.bin", &SaveState_FreezeGS, error))
+	{
+		return false;
+	}
+
+	SaveState_PostLoadPrep();
+	return true;
+}
+
+static bool SaveState_Load(SaveStateLoadSource& source, const char* name, Error* error)
+{
+	if (GSDumpReplayer::IsReplayingDump())
+	{
+		Error::SetString(error, "States can't be loaded while a GS dump is playing.");
+		return false;
+	}
+
+	Common::Timer timer;
+	bool vm_modified = false;
+	if (!SaveState_LoadFromSource(source, &vm_modified, error))
+	{
+		// Part of the VM has been overwritten, so it can't carry on. Start over instead, like
+		// VMManager::LoadState() does.
+		if (vm_modified)
+		{
+			Console.Error("(SaveState) Loading '%s' failed partway through, resetting the VM.", name);
+			VMManager::Reset();
+		}
+
+		return false;
+	}
+
+	DevCon.WriteLn("(SaveState) Loaded '%s' in %.2f ms.", name, timer.GetTimeMilliseconds());
+	return true;
+}
+
+bool SaveState_LoadFile(const char* filename, Error* error)
+{
+	zip_error_t ze = {};
+	auto zf = zip_open_managed(filename, ZIP_RDONLY, &ze);
+	if (!zf)
+	{
+		Error::SetStringFmt(error, "Failed to open '{}': {}", filename, zip_error_strerror(&ze));
+		return false;
+	}
+
+	if (zip_name_locate(zf.get(), EntryFilename_IncrementalBase, 0) < 0)
+	{
+		SaveStateArchiveSource source(zf.get());
+		return SaveState_Load(source, filename, error);
+	}
+
+	// Incremental saves are put back together with their base in memory, and loaded from there.
+	std::vector<std::string> names;
+	std::vector<std::vector<u8>> data;
+	if (!SaveState_RebuildIncremental(zf.get(), filename, &names, &data, error))
+		return false;
+
+	std::vector<SaveStateEntryData> entries;
+	entries.reserve(data.size());
+	for (size_t i = 0; i < data.size(); i++)
+		entries.push_back({names[i], data[i].data(), data[i].size()});
+
+	SaveStateMemorySource source(entries);
+	return SaveState_Load(source, filename, error);
+}
+
+bool SaveState_LoadEntries(const std::vector<SaveStateEntryData>& entries, Error* error)
+{
+	SaveStateMemorySource source(entries);
+	return SaveState_Load(source, "(memory)", error);
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "SaveState.h"
+
+#include <string>
+#include <vector>
+
+class Error;
+
+// OpenEmu's savestate writer and loader. The save path in PCSX2GameCore.mm captures the VM
+// with the regular SaveState_DownloadState() and hands the result to SaveState_WriteArchive()
+// instead of SaveState_ZipToDisk(). What comes out is an ordinary PCSX2 savestate, which
+// VMManager::LoadState() reads back like any other. PCSX2GameCore loads states with
+// SaveState_LoadFile() instead, which reads them more directly.
+
+/// One entry of a captured state. The data is owned by whoever captured the state.
+struct SaveStateEntryData
+{
+	std::string name;
+	const u8* data;
+	size_t size;
+};
+
+/// Lists the entries of a state captured with SaveState_DownloadState().
+std::vector<SaveStateEntryData> SaveState_GetEntries(ArchiveEntryList& list);
+
+enum class SaveStateCompression : u8
+{
+	Zstd,    ///< Compressed on the worker pool, for states that are kept.
+	Deflate, ///< Compressed by libzip on one thread, for when zstd savestates are turned off.
+	Store,   ///< Not compressed, for scratch states that are loaded straight back.
+};
+
+/// The compression for states that are kept: Zstd, or Deflate if
+/// EmuConfig.SavestateZstdCompression is off.
+SaveStateCompression SaveState_GetCompression();
+
+/// Writes \p entries, plus \p screenshot if there is one, to \p filename as a savestate.
+/// The file is only replaced once the whole archive has been written.
+bool SaveState_WriteArchive(const std::vector<SaveStateEntryData>& entries, SaveStateScreenshotData* screenshot,
+	const char* filename, SaveStateCompression compression, Error* error);
+
+/// Writes \p entries to memory with the zstd writer on 1, 2, 4 and 8 threads, and logs the
+/// best time and the archive size for each.
+void SaveState_BenchmarkCompression(const std::vector<SaveStateEntryData>& entries);
+
+/// Runs whatever the OE_SAVESTATE_* environment variables ask for on a state that has just
+/// been saved. PCSX2GameCore calls this from the save queue, and everything is reported in
+/// the log. The environment variables are:
+///   OE_SAVESTATE_BENCHMARK=1             runs SaveState_BenchmarkCompression()
+///   OE_SAVESTATE_THUMBNAIL_BENCHMARK=1   runs SaveState_BenchmarkThumbnailEncoders(), if
+///                                        there is a \p screenshot
+void SaveState_RunBenchmarksFromEnvironment(const std::vector<SaveStateEntryData>& entries, const SaveStateScreenshotData* screenshot);
+
+/// Flushes \p filename all the way to storage, so a completed save survives a crash or power loss.
+bool SaveState_SyncFileToDisk(const char* filename);
+
+/// Like SaveState_WriteArchive(), but large entries only get the 4KB pages that changed since
+/// the last full save. That full save, the base, is kept in the cache folder and shared by
+/// every incremental save with the same \p key, e.g. the disc serial. Both files carry the
+/// base id, so the save can be matched up with its base again after a restart. Bases that no
+/// save uses any more are deleted afterwards. Only SaveState_LoadFile() can load the result.
+bool SaveState_WriteIncremental(const std::vector<SaveStateEntryData>& entries, SaveStateScreenshotData* screenshot,
+	const char* filename, const std::string& key, Error* error);
+
+/// Loads the savestate \p filename into the VM, in place of VMManager::LoadState(). Incremental
+/// saves are put back together with their base in memory first. Call on the CPU thread. If the load fails after the VM has been partly overwritten, the VM is
+/// reset, as VMManager::LoadState() does.
+bool SaveState_LoadFile(const char* filename, Error* error);
+
+/// Like SaveState_LoadFile(), for a state captured with SaveState_DownloadState() that is still
+/// held in memory, so it doesn't have to go through a file.
+bool SaveState_LoadEntries(const std::vector<SaveStateEntryData>& entries, Error* error);
+
+enum class SaveStateThumbnailCodec : u8
+{
+	PNG, ///< Same as upstream, libpng at level 5 with adaptive filtering.
+	FastPNG, ///< Unfiltered, deflate level 1. Bigger, but several times faster to encode. The default.
+	WebPLossless, ///< Smallest, stored as "Screenshot.webp", which upstream doesn't show.
+};
+
+/// Picks the encoder for thumbnails in states saved from now on.
+void SaveState_SetThumbnailCodec(SaveStateThumbnailCodec codec);
+SaveStateThumbnailCodec SaveState_GetThumbnailCodec();
+
+/// Applies the OE_SAVESTATE_* settings that aren't benchmarks. PCSX2GameCore calls this when
+/// the VM starts. The environment variables are:
+///   OE_SAVESTATE_THUMBNAIL_CODEC=png|fastpng|webp   sets the thumbnail codec
+void SaveState_ConfigureFromEnvironment();
+
+/// Reads the thumbnail of the savestate \p filename as opaque RGBA pixels, whichever codec it
+/// was written with.
+bool SaveState_ReadThumbnail(const char* filename, u32* out_width, u32* out_height, std::vector<u32>* out_pixels);
+
+/// Encodes \p data with every thumbnail codec, reads it back, and logs the times and size for each.
+void SaveState_BenchmarkThumbnailEncoders(const SaveStateScreenshotData& data);
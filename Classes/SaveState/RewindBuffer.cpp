@@ -0,0 +1,339 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "PrecompiledHeader.h"
+#include "RewindBuffer.h"
+#include "OESaveState.h"
+
+#include "common/Console.h"
+#include "common/Error.h"
+#include "common/Timer.h"
+
+#include "lz4.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Rewind
+{
+	static constexpr u32 PageSize = 4096;
+
+	struct EntryInfo
+	{
+		std::string name;
+		u32 index;
+		u32 size;
+
+		bool operator==(const EntryInfo& rhs) const
+		{
+			return index == rhs.index && size == rhs.size && name == rhs.name;
+		}
+	};
+
+	struct Snapshot
+	{
+		std::vector<EntryInfo> entries; ///< Layout of the state this snapshot restores.
+		u32 state_size;
+		bool keyframe; ///< Holds the whole state, because the layout changed since.
+		std::vector<u64> changed_pages;
+		u32 uncompressed_size;
+		std::vector<u8> data;
+
+		size_t GetMemoryUsage() const
+		{
+			return data.size() + changed_pages.size() * sizeof(u64) + sizeof(*this);
+		}
+	};
+
+	static std::vector<EntryInfo> GetEntryInfo(ArchiveEntryList& list);
+	static u32 GetStateSize(const std::vector<EntryInfo>& entries);
+	static void Compress(Snapshot& snap, const u8* src, u32 size);
+	static void EvictToBudget();
+	static bool LoadCurrent();
+
+	static Settings s_settings;
+	static u32 s_frames_since_capture = 0;
+
+	static std::vector<u8> s_current; ///< The newest state, whole.
+	static std::vector<EntryInfo> s_current_entries;
+
+	static std::deque<Snapshot> s_snapshots;
+	static size_t s_memory_used = 0; ///< By the snapshots. s_current comes on top.
+	static std::vector<u8> s_scratch;
+
+	static Statistics s_stats = {};
+} // namespace Rewind
+
+std::vector<Rewind::EntryInfo> Rewind::GetEntryInfo(ArchiveEntryList& list)
+{
+	std::vector<EntryInfo> entries;
+	entries.reserve(list.GetLength());
+	for (uint i = 0; i < list.GetLength(); i++)
+	{
+		const ArchiveEntry& entry = list[i];
+		entries.push_back({entry.GetFilename(), static_cast<u32>(entry.GetDataIndex()), static_cast<u32>(entry.GetDataSize())});
+	}
+
+	return entries;
+}
+
+u32 Rewind::GetStateSize(const std::vector<EntryInfo>& entries)
+{
+	u32 size = 0;
+	for (const EntryInfo& entry : entries)
+		size = std::max(size, entry.index + entry.size);
+
+	return size;
+}
+
+void Rewind::Compress(Snapshot& snap, const u8* src, u32 size)
+{
+	snap.uncompressed_size = size;
+	snap.data.resize(LZ4_compressBound(static_cast<int>(size)));
+	const int compressed = LZ4_compress_default(reinterpret_cast<const char*>(src), reinterpret_cast<char*>(snap.data.data()),
+		static_cast<int>(size), static_cast<int>(snap.data.size()));
+	snap.data.resize(std::max(compressed, 0));
+	snap.data.shrink_to_fit();
+}
+
+void Rewind::EvictToBudget()
+{
+	// The newest state counts against the budget too, it is by far the biggest single item.
+	while (!s_snapshots.empty() && s_memory_used + s_current.size() > s_settings.memory_budget)
+	{
+		s_memory_used -= s_snapshots.front().GetMemoryUsage();
+		s_snapshots.pop_front();
+	}
+}
+
+bool Rewind::LoadCurrent()
+{
+	// Loaded straight from memory, through the same loader as states from disk.
+	std::vector<SaveStateEntryData> entries;
+	entries.reserve(s_current_entries.size());
+	for (const EntryInfo& entry : s_current_entries)
+	{
+		if (entry.size)
+			entries.push_back({entry.name, s_current.data() + entry.index, entry.size});
+	}
+
+	Error error;
+	if (!SaveState_LoadEntries(entries, &error))
+	{
+		Console.Error("(Rewind) Failed to restore snapshot: %s", error.GetDescription().c_str());
+		return false;
+	}
+
+	return true;
+}
+
+void Rewind::SetSettings(const Settings& settings)
+{
+	if (!settings.enabled)
+		Clear();
+
+	s_settings = settings;
+	s_settings.frame_interval = std::max(s_settings.frame_interval, 1u);
+	EvictToBudget();
+}
+
+const Rewind::Settings& Rewind::GetSettings()
+{
+	return s_settings;
+}
+
+void Rewind::OnVSync()
+{
+	if (!s_settings.enabled)
+		return;
+
+	if (++s_frames_since_capture < s_settings.frame_interval)
+		return;
+
+	s_frames_since_capture = 0;
+	Capture();
+}
+
+void Rewind::Capture()
+{
+	Common::Timer timer;
+
+	std::unique_ptr<ArchiveEntryList> state = SaveState_DownloadState();
+	if (!state)
+	{
+		Console.Error("(Rewind) Failed to capture the VM state.");
+		return;
+	}
+
+	std::vector<EntryInfo> entries = GetEntryInfo(*state);
+	const u32 size = GetStateSize(entries);
+	const u8* new_data = state->GetPtr(0);
+
+	if (!s_current.empty())
+	{
+		Snapshot snap;
+		snap.entries = s_current_entries;
+		snap.state_size = static_cast<u32>(s_current.size());
+		snap.keyframe = (entries != s_current_entries);
+
+		if (snap.keyframe)
+		{
+			Compress(snap, s_current.data(), snap.state_size);
+			s_current.assign(new_data, new_data + size);
+			s_stats.last_changed_pages = (size + PageSize - 1) / PageSize;
+		}
+		else
+		{
+			// Only pages that changed make it into the delta. XOR is its own inverse, so the
+			// same data turns the new state back into the old one. Pages that didn't change
+			// are already identical in s_current, so only the changed ones are copied over.
+			u8* old_data = s_current.data();
+			const u32 num_pages = (size + PageSize - 1) / PageSize;
+			u32 changed_pages = 0;
+			snap.changed_pages.resize((num_pages + 63) / 64);
+			s_scratch.clear();
+
+			for (u32 page = 0; page < num_pages; page++)
+			{
+				const u32 offset = page * PageSize;
+				const u32 length = std::min(PageSize, size - offset);
+				if (std::memcmp(old_data + offset, new_data + offset, length) == 0)
+					continue;
+
+				snap.changed_pages[page / 64] |= (1ull << (page % 64));
+				const size_t pos = s_scratch.size();
+				s_scratch.resize(pos + length);
+				for (u32 i = 0; i < length; i++)
+					s_scratch[pos + i] = old_data[offset + i] ^ new_data[offset + i];
+				std::memcpy(old_data + offset, new_data + offset, length);
+				changed_pages++;
+			}
+
+			s_stats.last_changed_pages = changed_pages;
+			Compress(snap, s_scratch.data(), static_cast<u32>(s_scratch.size()));
+		}
+
+		s_stats.last_snapshot_size = snap.data.size();
+		s_memory_used += snap.GetMemoryUsage();
+		s_snapshots.push_back(std::move(snap));
+		EvictToBudget();
+	}
+	else
+	{
+		s_current.assign(new_data, new_data + size);
+	}
+
+	s_current_entries = std::move(entries);
+
+	const double ms = timer.GetTimeMilliseconds();
+	s_stats.last_capture_ms = ms;
+	s_stats.max_capture_ms = std::max(s_stats.max_capture_ms, ms);
+	s_stats.average_capture_ms = (s_stats.average_capture_ms == 0.0) ? ms : (s_stats.average_capture_ms * 0.9 + ms * 0.1);
+	s_stats.average_frame_cost_ms = s_stats.average_capture_ms / s_settings.frame_interval;
+}
+
+bool Rewind::StepBack()
+{
+	if (s_current.empty() || s_snapshots.empty())
+		return false;
+
+	Snapshot& snap = s_snapshots.back();
+	s_scratch.resize(snap.uncompressed_size);
+	if (snap.uncompressed_size > 0 &&
+		LZ4_decompress_safe(reinterpret_cast<const char*>(snap.data.data()), reinterpret_cast<char*>(s_scratch.data()),
+			static_cast<int>(snap.data.size()), static_cast<int>(snap.uncompressed_size)) != static_cast<int>(snap.uncompressed_size))
+	{
+		Console.Error("(Rewind) Snapshot is corrupted, discarding history.");
+		Clear();
+		return false;
+	}
+
+	if (snap.keyframe)
+	{
+		s_current.assign(s_scratch.begin(), s_scratch.begin() + snap.state_size);
+	}
+	else
+	{
+		u8* data = s_current.data();
+		const u8* delta = s_scratch.data();
+		for (u32 word = 0; word < snap.changed_pages.size(); word++)
+		{
+			for (u64 bits = snap.changed_pages[word]; bits != 0; bits &= bits - 1)
+			{
+				const u32 offset = (word * 64 + std::countr_zero(bits)) * PageSize;
+				const u32 length = std::min(PageSize, snap.state_size - offset);
+				for (u32 i = 0; i < length; i++)
+					data[offset + i] ^= delta[i];
+				delta += length;
+			}
+		}
+	}
+
+	s_current_entries = std::move(snap.entries);
+	s_memory_used -= snap.GetMemoryUsage();
+	s_snapshots.pop_back();
+	s_frames_since_capture = 0;
+
+	// If the load fails the VM is still where it was, which no longer matches the history.
+	if (!LoadCurrent())
+	{
+		Clear();
+		return false;
+	}
+
+	return true;
+}
+
+void Rewind::Clear()
+{
+	if (!s_snapshots.empty())
+	{
+		const Statistics stats = GetStatistics();
+		DevCon.WriteLn("(Rewind) Dropping %u snapshots, %zu KB. Last delta %zu KB with %u changed pages. "
+			"Capture %.2f ms average, %.2f ms max, %.3f ms per frame.",
+			stats.snapshot_count, stats.memory_used / 1024, stats.last_snapshot_size / 1024, stats.last_changed_pages,
+			stats.average_capture_ms, stats.max_capture_ms, stats.average_frame_cost_ms);
+	}
+
+	s_snapshots.clear();
+	s_current = {};
+	s_current_entries.clear();
+	s_memory_used = 0;
+	s_frames_since_capture = 0;
+	s_scratch = {};
+	s_stats = {};
+}
+
+Rewind::Statistics Rewind::GetStatistics()
+{
+	Statistics stats = s_stats;
+	stats.snapshot_count = static_cast<u32>(s_snapshots.size());
+	stats.memory_used = s_memory_used + s_current.size();
+	return stats;
+}
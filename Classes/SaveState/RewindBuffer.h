@@ -0,0 +1,81 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "common/Pcsx2Defs.h"
+
+#include <cstddef>
+
+/// In-memory rewind history. Every few frames the VM is snapshotted with
+/// SaveState_DownloadState(). Only the newest snapshot is kept whole. Each older one is kept
+/// as the LZ4-compressed XOR of the 4KB pages that differ from the snapshot after it, so
+/// stepping back just XORs one delta into the newest state. The oldest deltas are dropped
+/// once the memory budget is used up.
+///
+/// PCSX2GameCore calls OnVSync() from Host::PumpMessagesOnCPUThread(), and turns history on
+/// and off and steps back from the "Rewind" display mode menu.
+///
+/// Everything here has to be called on the CPU thread.
+namespace Rewind
+{
+	struct Settings
+	{
+		bool enabled = false;
+		u32 frame_interval = 10; ///< Take a snapshot every this many frames.
+		size_t memory_budget = 256 * _1mb; ///< Bytes of history to keep, including the newest state.
+	};
+
+	struct Statistics
+	{
+		u32 snapshot_count;
+		size_t memory_used; ///< Including the newest state.
+		size_t last_snapshot_size; ///< Compressed size of the most recent delta.
+		u32 last_changed_pages; ///< Pages that differed from the previous snapshot.
+		double last_capture_ms; ///< EE thread time spent on the most recent snapshot.
+		double average_capture_ms;
+		double max_capture_ms;
+		double average_frame_cost_ms; ///< Average capture time spread over the capture interval.
+	};
+
+	void SetSettings(const Settings& settings);
+	const Settings& GetSettings();
+
+	/// Counts frames and takes a snapshot when the interval is up. Call once per vsync.
+	void OnVSync();
+
+	/// Takes a snapshot right away.
+	void Capture();
+
+	/// Restores the VM to the previous snapshot, by loading it from memory with
+	/// SaveState_LoadEntries(). Returns false if there is no history left, or if the load
+	/// failed, which also clears the history.
+	bool StepBack();
+
+	/// Throws away all history, e.g. after a reset or regular state load. The statistics for it
+	/// are logged first.
+	void Clear();
+
+	Statistics GetStatistics();
+} // namespace Rewind
@@ -4,6 +4,11 @@
 #include "GS.h"
 #include "GS/GSLzma.h"
 #include "GSDumpReplayer.h"
+#include "GSDumpReplayerBenchmark.h"
+#include "GSDumpStream.h"
+#include "GS/GSState.h"
+#include "GS/Renderers/Common/GSDevice.h"
+#include "GS/Renderers/HW/GSTextureCache.h"
 #include "GameList.h"
 #include "Gif.h"
 #include "Gif_Unit.h"
@@ -12,6 +17,7 @@
 //#include "ImGui/ImGuiOverlays.h"
 #include "R3000A.h"
 #include "R5900.h"
+#include "MTGS.h"
 #include "VMManager.h"
 #include "VUmicro.h"
 
@@ -26,7 +32,22 @@
 #include "common/Threading.h"
 #include "common/Timer.h"
 
+#include <algorithm>
 #include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+#include "xxhash.h"
+
+#ifdef __APPLE__
+#include <mach/mach.h>
+#else
+#include <sys/resource.h>
+#endif
 
 static void GSDumpReplayerCpuReserve();
 static void GSDumpReplayerCpuShutdown();
@@ -37,8 +58,7 @@ static void GSDumpReplayerExitExecution();
 static void GSDumpReplayerCancelInstruction();
 static void GSDumpReplayerCpuClear(u32 addr, u32 size);
 
-static std::unique_ptr<GSDumpFile> s_dump_file;
-static u32 s_current_packet = 0;
+static std::unique_ptr<GSDumpStream> s_dump_file;
 static u32 s_dump_frame_number = 0;
 static s32 s_dump_loop_count = 0;
 static bool s_dump_running = false;
@@ -47,6 +67,72 @@ static u64 s_frame_ticks = 0;
 static u64 s_next_frame_time = 0;
 static bool s_is_dump_runner = false;
 
+// Benchmark mode. CPU time and the post time are written on the CPU thread, the rest by a
+// marker queued behind each vsync that runs on the GS thread. A deque doesn't move its
+// elements as it grows, so the GS thread can fill in a frame while the next is appended.
+struct BenchmarkFrame
+{
+	u64 cpu_ticks; ///< CPU thread time since the previous vsync.
+	u64 posted; ///< When the vsync was queued to the MTGS.
+	u64 completed; ///< When the GS thread got through it.
+	u32 draws;
+};
+
+static std::string s_benchmark_report_path;
+static std::string s_benchmark_dump_name;
+static s32 s_benchmark_loops = 0;
+static std::deque<BenchmarkFrame> s_benchmark_frames;
+static bool s_benchmark_started = false;
+static u64 s_benchmark_start_time = 0; ///< When the GS thread finished the first frame.
+static u64 s_benchmark_last_vsync_time = 0;
+static int s_benchmark_last_draw = 0;
+
+// Frame hashing. After every vsync of the first loop, the GS thread reads back the output
+// and hashes it into the frame's slot, while the CPU thread carries on queuing the next
+// frame. Once the loop is done the hashes are checked against, or saved as, the baseline.
+// Frames are read back 1:1 at the size of the renderer's output, which is the native
+// resolution with the Software renderer or at 1x upscaling, so no filtering gets hashed.
+
+static std::string s_hash_baseline_path;
+static bool s_hash_update_baseline = false;
+static bool s_hash_finished = true;
+static std::deque<u64> s_frame_hashes; ///< By frame number - 1. 0 when there was no output.
+static u32 s_frame_hash_mismatches = 0;
+
+// Batch mode. Frames are timed as in benchmark mode, and once a dump has recorded enough of
+// them the next one is switched in with ChangeDump(). Texture cache sizes are sampled by the
+// benchmark marker on the GS thread, memory at each vsync on the CPU thread.
+struct TimeStats
+{
+	double mean, p50, p95, p99, max;
+};
+
+struct BatchResult
+{
+	std::string dump;
+	bool loaded = false;
+	u32 frames = 0;
+	double seconds = 0.0;
+	TimeStats frame_ms = {}; ///< Between the GS thread finishing one frame and the next.
+	TimeStats cpu_ms = {};
+	u64 draws = 0;
+	size_t tc_source_peak = 0;
+	size_t tc_target_peak = 0;
+	u64 peak_memory = 0;
+	std::string error; ///< Why the dump didn't load or didn't replay cleanly, if it didn't.
+};
+
+static std::vector<std::string> s_batch_dumps;
+static std::string s_batch_report_path;
+static u32 s_batch_frames = 0;
+static size_t s_batch_index = 0;
+static bool s_batch_dump_done = false;
+static std::vector<BatchResult> s_batch_results;
+static size_t s_batch_tc_source_peak = 0;
+static size_t s_batch_tc_target_peak = 0;
+static u64 s_batch_peak_memory = 0;
+static std::string s_batch_dump_error;
+
 R5900cpu GSDumpReplayerCpu = {
 	GSDumpReplayerCpuReserve,
 	GSDumpReplayerCpuShutdown,
@@ -88,19 +174,18 @@ int GSDumpReplayer::GetLoopCount()
 bool GSDumpReplayer::Initialize(const char* filename, Error* error)
 {
 	Common::Timer timer;
-	Console.WriteLn("(GSDumpReplayer) Reading file '%s'...", filename);
+	Console.WriteLn("(GSDumpReplayer) Opening file '%s'...", filename);
 
 	Error dump_error;
-	s_dump_file = GSDumpFile::OpenGSDump(filename, &dump_error);
-	if (!s_dump_file || !s_dump_file->ReadFile(&dump_error))
+	s_dump_file = GSDumpStream::Open(filename, &dump_error);
+	if (!s_dump_file)
 	{
 		Error::SetStringFmt(error, TRANSLATE_FS("GSDumpReplayer", "Failed to open or read '{}': {}"),
 			Path::GetFileName(filename), dump_error.GetDescription());
-		s_dump_file.reset();
 		return false;
 	}
 
-	Console.WriteLn("(GSDumpReplayer) Read file in %.2f ms.", timer.GetTimeMilliseconds());
+	Console.WriteLn("(GSDumpReplayer) Opened file in %.2f ms.", timer.GetTimeMilliseconds());
 
 	// We replace all CPUs.
 	Cpu = &GSDumpReplayerCpu;
@@ -111,36 +196,193 @@ bool GSDumpReplayer::Initialize(const char* filename, Error* error)
 	// loop infinitely by default
 	s_dump_loop_count = -1;
 
+	if (!s_benchmark_report_path.empty())
+	{
+		s_dump_loop_count = s_benchmark_loops - 1;
+		s_benchmark_dump_name = Path::GetFileName(filename);
+		s_benchmark_frames.clear();
+		s_benchmark_started = false;
+		Console.WriteLn("(GSDumpReplayer) Benchmarking %d loops.", s_benchmark_loops);
+	}
+
+	if (!s_hash_baseline_path.empty())
+	{
+		s_frame_hashes.clear();
+		s_frame_hash_mismatches = 0;
+		s_hash_finished = false;
+	}
+
+	if (!s_batch_dumps.empty())
+	{
+		s_batch_index = 0;
+		s_batch_dump_done = false;
+		s_batch_results.clear();
+		s_benchmark_frames.clear();
+		s_benchmark_started = false;
+		s_batch_tc_source_peak = 0;
+		s_batch_tc_target_peak = 0;
+		s_batch_peak_memory = 0;
+		s_batch_dump_error.clear();
+		Console.WriteLn("(GSDumpReplayer) Running %zu dumps for %u frames each.", s_batch_dumps.size(), s_batch_frames);
+	}
+
 	return true;
 }
 
-bool GSDumpReplayer::ChangeDump(const char* filename)
+void GSDumpReplayer::SetFrameHashing(std::string baseline_path, bool update_baseline)
+{
+	s_hash_baseline_path = std::move(baseline_path);
+	s_hash_update_baseline = update_baseline;
+}
+
+u32 GSDumpReplayer::GetFrameHashMismatches()
+{
+	return s_frame_hash_mismatches;
+}
+
+void GSDumpReplayer::SetBenchmarkMode(std::string report_path, s32 loops)
+{
+	s_benchmark_report_path = std::move(report_path);
+	s_benchmark_loops = std::max(loops, 1);
+}
+
+bool GSDumpReplayer::IsBenchmarking()
+{
+	return !s_benchmark_report_path.empty();
+}
+
+void GSDumpReplayer::ConfigureFromEnvironment(std::string* filename)
+{
+	if (const char* env = std::getenv("OE_GSDUMP_BLOCK_COMPRESS"); env && *env)
+	{
+		const char* level = std::getenv("OE_GSDUMP_BLOCK_COMPRESS_LEVEL");
+		Console.WriteLn("(GSDumpReplayer) Block-compressing '%s' to '%s'...", filename->c_str(), env);
+
+		Common::Timer timer;
+		Error error;
+		if (!VMManager::IsGSDumpFileName(env))
+		{
+			Console.Error("(GSDumpReplayer) '%s' is not a GS dump file name, use .gs.zst.", env);
+		}
+		else if (GSDumpStream::WriteBlockCompressed(filename->c_str(), env, level ? std::atoi(level) : 3, &error))
+		{
+			Console.WriteLn("(GSDumpReplayer) Block-compressed in %.2f ms.", timer.GetTimeMilliseconds());
+			*filename = env;
+		}
+		else
+		{
+			Console.Error("(GSDumpReplayer) Failed to block-compress '%s': %s", filename->c_str(),
+				error.GetDescription().c_str());
+		}
+	}
+
+	if (const char* env = std::getenv("OE_GSDUMP_HASH_BASELINE"); env && *env)
+	{
+		const char* update = std::getenv("OE_GSDUMP_HASH_UPDATE");
+		SetFrameHashing(env, update && std::strcmp(update, "1") == 0);
+	}
+
+	if (const char* env = std::getenv("OE_GSDUMP_BENCHMARK"); env && *env)
+	{
+		const char* loops = std::getenv("OE_GSDUMP_BENCHMARK_LOOPS");
+		SetBenchmarkMode(env, loops ? static_cast<s32>(std::strtol(loops, nullptr, 10)) : 1);
+	}
+
+	if (const char* env = std::getenv("OE_GSDUMP_BATCH"); env && *env)
+	{
+		const char* report = std::getenv("OE_GSDUMP_BATCH_REPORT");
+		const char* frames = std::getenv("OE_GSDUMP_BATCH_FRAMES");
+
+		std::vector<std::string> paths;
+		for (const std::string_view path : StringUtil::SplitString(env, ':', true))
+			paths.emplace_back(path);
+
+		if (!report || !*report)
+			Console.Error("(GSDumpReplayer) OE_GSDUMP_BATCH needs OE_GSDUMP_BATCH_REPORT to be set.");
+		else if (!SetBatchMode(paths, frames ? static_cast<u32>(std::strtoul(frames, nullptr, 10)) : 1000, report))
+			Console.Error("(GSDumpReplayer) No GS dumps found in '%s'.", env);
+		else
+			*filename = s_batch_dumps.front();
+	}
+}
+
+bool GSDumpReplayer::SetBatchMode(const std::vector<std::string>& paths, u32 frames, std::string report_path)
+{
+	s_batch_dumps.clear();
+	for (const std::string& path : paths)
+	{
+		if (!FileSystem::DirectoryExists(path.c_str()))
+		{
+			s_batch_dumps.push_back(path);
+			continue;
+		}
+
+		FileSystem::FindResultsArray results;
+		FileSystem::FindFiles(path.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_SORT_BY_NAME, &results);
+		for (const FILESYSTEM_FIND_DATA& fd : results)
+		{
+			if (VMManager::IsGSDumpFileName(fd.FileName))
+				s_batch_dumps.push_back(fd.FileName);
+		}
+	}
+
+	s_batch_frames = std::max(frames, 1u);
+	s_batch_report_path = std::move(report_path);
+	s_benchmark_report_path.clear();
+	return !s_batch_dumps.empty();
+}
+
+const std::vector<std::string>& GSDumpReplayer::GetBatchDumps()
+{
+	return s_batch_dumps;
+}
+
+static bool GSDumpReplayerChangeDump(const char* filename, Error* error)
 {
 	Console.WriteLn("(GSDumpReplayer) Switching to '%s'...", filename);
 
 	if (!VMManager::IsGSDumpFileName(filename))
 	{
-		Host::ReportFormattedErrorAsync("GSDumpReplayer", "'%s' is not a GS dump.", filename);
+		Error::SetStringFmt(error, "'{}' is not a GS dump.", Path::GetFileName(filename));
 		return false;
 	}
 
-	Error error;
-	std::unique_ptr<GSDumpFile> new_dump(GSDumpFile::OpenGSDump(filename));
-	if (!new_dump || !new_dump->ReadFile(&error))
+	Error open_error;
+	std::unique_ptr<GSDumpStream> new_dump = GSDumpStream::Open(filename, &open_error);
+	if (!new_dump)
 	{
-		Host::ReportErrorAsync("GSDumpReplayer", fmt::format("Failed to open or read '{}': {}",
-													 Path::GetFileName(filename), error.GetDescription()));
+		Error::SetStringFmt(error, "Failed to open or read '{}': {}", Path::GetFileName(filename), open_error.GetDescription());
 		return false;
 	}
 
 	s_dump_file = std::move(new_dump);
-	s_current_packet = 0;
+
+	if (!s_hash_finished)
+	{
+		Console.Warning("(GSDumpReplayer) Dump changed, frame hashing stopped.");
+		s_hash_finished = true;
+	}
 
 	// Don't forget to reset the GS!
 	GSDumpReplayerCpuReset();
 	return true;
 }
 
+bool GSDumpReplayer::ChangeDump(const char* filename)
+{
+	Error error;
+	if (GSDumpReplayerChangeDump(filename, &error))
+		return true;
+
+	// A batch runs unattended, so it mustn't stop at a dialog.
+	if (!s_batch_dumps.empty())
+		Console.Error("(GSDumpReplayer) %s", error.GetDescription().c_str());
+	else
+		Host::ReportErrorAsync("GSDumpReplayer", error.GetDescription());
+
+	return false;
+}
+
 void GSDumpReplayer::Shutdown()
 {
 	Console.WriteLn("(GSDumpReplayer) Shutting down.");
@@ -194,8 +436,9 @@ void GSDumpReplayerCpuShutdown()
 void GSDumpReplayerCpuReset()
 {
 	s_needs_state_loaded = true;
-	s_current_packet = 0;
 	s_dump_frame_number = 0;
+	if (s_dump_file)
+		s_dump_file->Rewind();
 }
 
 static void GSDumpReplayerLoadInitialState()
@@ -210,7 +453,19 @@ static void GSDumpReplayerLoadInitialState()
 	MTGS::FreezeData mfd = {&fd, 0};
 	MTGS::Freeze(FreezeAction::Load, mfd);
 	if (mfd.retval != 0)
-		Host::ReportFormattedErrorAsync("GSDumpReplayer", "Failed to load GS state.");
+	{
+		// The batch carries on, the report says which dump it was.
+		if (!s_batch_dumps.empty())
+		{
+			Console.Error("(GSDumpReplayer) Failed to load GS state.");
+			if (s_batch_dump_error.empty())
+				s_batch_dump_error = "Failed to load GS state.";
+		}
+		else
+		{
+			Host::ReportFormattedErrorAsync("GSDumpReplayer", "Failed to load GS state.");
+		}
+	}
 }
 
 static void GSDumpReplayerSendPacketToMTGS(GIF_PATH path, const u8* data, size_t length)
@@ -229,6 +484,383 @@ static void GSDumpReplayerSendPacketToMTGS(GIF_PATH path, const u8* data, size_t
 	Gif_AddCompletedGSPacket(gsPack, path);
 }
 
+static void GSDumpReplayerBenchmarkVSync()
+{
+	const u64 now = GetCPUTicks();
+	if (!s_benchmark_started)
+	{
+		// The first frame includes loading the state, which isn't what's being measured.
+		s_benchmark_started = true;
+		s_benchmark_last_vsync_time = now;
+		return;
+	}
+
+	BenchmarkFrame& frame = s_benchmark_frames.emplace_back();
+	frame.cpu_ticks = now - s_benchmark_last_vsync_time;
+	frame.posted = now;
+	s_benchmark_last_vsync_time = now;
+}
+
+static void GSDumpReplayerBenchmarkMarker()
+{
+	// Queued right behind the vsync, so these run once the GS thread has done the frame.
+	// Frame times start from the GS thread finishing the first frame, not the CPU thread
+	// queuing it, so the GS side of the state load isn't counted in the second frame.
+	if (s_benchmark_frames.empty())
+	{
+		MTGS::RunOnGSThread([]() {
+			s_benchmark_start_time = GetCPUTicks();
+			s_benchmark_last_draw = GSState::s_n;
+		});
+		return;
+	}
+
+	BenchmarkFrame* frame = &s_benchmark_frames.back();
+	MTGS::RunOnGSThread([frame]() {
+		frame->completed = GetCPUTicks();
+		frame->draws = static_cast<u32>(GSState::s_n - s_benchmark_last_draw);
+		s_benchmark_last_draw = GSState::s_n;
+
+		if (g_texture_cache)
+		{
+			s_batch_tc_source_peak = std::max<size_t>(s_batch_tc_source_peak, g_texture_cache->GetSourceMemoryUsage());
+			s_batch_tc_target_peak = std::max<size_t>(s_batch_tc_target_peak, g_texture_cache->GetTargetMemoryUsage());
+		}
+	});
+}
+
+static void GSDumpReplayerQueueFrameHash()
+{
+	if (s_hash_finished || s_dump_frame_number == 0)
+		return;
+
+	u64* hash = &s_frame_hashes.emplace_back(0);
+	MTGS::RunOnGSThread([hash]() {
+		GSTexture* const current = g_gs_device ? g_gs_device->GetCurrent() : nullptr;
+		if (!current)
+			return;
+
+		// Same size and no aspect correction, so the output is copied rather than rescaled.
+		u32 width, height;
+		std::vector<u32> pixels;
+		if (GSSaveSnapshotToMemory(current->GetWidth(), current->GetHeight(), false, false, &width, &height, &pixels))
+			*hash = XXH64(pixels.data(), pixels.size() * sizeof(u32), (static_cast<u64>(width) << 32) | height);
+	});
+}
+
+static bool GSDumpReplayerReadFrameHashes(const std::string& path, std::unordered_map<u32, u64>* hashes)
+{
+	std::optional<std::string> contents = FileSystem::ReadFileToString(path.c_str());
+	if (!contents.has_value())
+		return false;
+
+	std::string_view remaining = contents.value();
+	while (!remaining.empty())
+	{
+		const size_t end = std::min(remaining.find('\n'), remaining.size());
+		const std::string line(remaining.substr(0, end));
+		remaining.remove_prefix(std::min(end + 1, remaining.size()));
+
+		unsigned int frame;
+		unsigned long long hash;
+		if (line.empty() || line[0] == '#' || std::sscanf(line.c_str(), "%u %llx", &frame, &hash) != 2)
+			continue;
+
+		hashes->emplace(frame, hash);
+	}
+
+	return true;
+}
+
+static void GSDumpReplayerFinishFrameHashes()
+{
+	MTGS::WaitGS(false);
+	s_hash_finished = true;
+
+	std::unordered_map<u32, u64> baseline;
+	const bool have_baseline = !s_hash_update_baseline && GSDumpReplayerReadFrameHashes(s_hash_baseline_path, &baseline);
+	if (!have_baseline)
+	{
+		std::string contents = fmt::format("# Frame hashes for {}, XXH64 of each frame at the output resolution\n",
+			s_dump_file->GetSerial());
+		for (size_t i = 0; i < s_frame_hashes.size(); i++)
+			contents += fmt::format("{} {:016x}\n", i + 1, s_frame_hashes[i]);
+
+		Error error;
+		if (!FileSystem::WriteStringToFile(s_hash_baseline_path.c_str(), contents, &error))
+		{
+			Console.Error("(GSDumpReplayer) Failed to write frame hashes to '%s': %s", s_hash_baseline_path.c_str(),
+				error.GetDescription().c_str());
+			return;
+		}
+
+		Console.WriteLn("(GSDumpReplayer) Saved %zu frame hashes as the baseline in '%s'.", s_frame_hashes.size(),
+			s_hash_baseline_path.c_str());
+		return;
+	}
+
+	static constexpr u32 MAX_REPORTED_MISMATCHES = 16;
+	s_frame_hash_mismatches = 0;
+	for (size_t i = 0; i < s_frame_hashes.size(); i++)
+	{
+		const u32 frame = static_cast<u32>(i + 1);
+		const auto it = baseline.find(frame);
+		if (it != baseline.end() && it->second == s_frame_hashes[i])
+			continue;
+
+		if (s_frame_hash_mismatches++ < MAX_REPORTED_MISMATCHES)
+		{
+			if (it == baseline.end())
+				Console.Error("(GSDumpReplayer) Frame %u is missing from the baseline.", frame);
+			else
+				Console.Error("(GSDumpReplayer) Frame %u differs: %016llx, baseline %016llx.", frame,
+					static_cast<unsigned long long>(s_frame_hashes[i]), static_cast<unsigned long long>(it->second));
+		}
+	}
+
+	if (baseline.size() != s_frame_hashes.size())
+	{
+		Console.Warning("(GSDumpReplayer) Baseline has %zu frames, the dump %zu.", baseline.size(), s_frame_hashes.size());
+	}
+
+	if (s_frame_hash_mismatches == 0)
+		Console.WriteLn("(GSDumpReplayer) All %zu frames match the baseline.", s_frame_hashes.size());
+	else
+		Console.Error("(GSDumpReplayer) %u of %zu frames differ from the baseline.", s_frame_hash_mismatches, s_frame_hashes.size());
+}
+
+static std::string GSDumpReplayerEscapeJSON(std::string_view str)
+{
+	std::string ret;
+	ret.reserve(str.size());
+	for (const char ch : str)
+	{
+		if (ch == '"' || ch == '\\')
+			ret += '\\';
+		if (static_cast<u8>(ch) < 0x20)
+			ret += fmt::format("\\u{:04x}", static_cast<u8>(ch));
+		else
+			ret += ch;
+	}
+	return ret;
+}
+
+static TimeStats GSDumpReplayerGetTimeStats(std::vector<double> values)
+{
+	TimeStats stats = {};
+	if (values.empty())
+		return stats;
+
+	std::sort(values.begin(), values.end());
+	const auto percentile = [&values](double p) { return values[static_cast<size_t>(p * (values.size() - 1))]; };
+	double sum = 0.0;
+	for (double value : values)
+		sum += value;
+
+	stats.mean = sum / values.size();
+	stats.p50 = percentile(0.5);
+	stats.p95 = percentile(0.95);
+	stats.p99 = percentile(0.99);
+	stats.max = values.back();
+	return stats;
+}
+
+static std::string GSDumpReplayerFormatTimeStats(const TimeStats& stats)
+{
+	return fmt::format("{{\"mean\": {:.4f}, \"p50\": {:.4f}, \"p95\": {:.4f}, \"p99\": {:.4f}, \"max\": {:.4f}}}",
+		stats.mean, stats.p50, stats.p95, stats.p99, stats.max);
+}
+
+static void GSDumpReplayerWriteBenchmarkReport()
+{
+	MTGS::WaitGS(false);
+
+	const u32 count = static_cast<u32>(s_benchmark_frames.size());
+	const double ticks_per_ms = static_cast<double>(GetTickFrequency()) / 1000.0;
+	const double seconds = (count > 0) ? ((s_benchmark_frames[count - 1].completed - s_benchmark_start_time) / (ticks_per_ms * 1000.0)) : 0.0;
+
+	std::vector<double> cpu_ms(count), queue_ms(count);
+	u64 total_draws = 0;
+	for (u32 i = 0; i < count; i++)
+	{
+		cpu_ms[i] = s_benchmark_frames[i].cpu_ticks / ticks_per_ms;
+		queue_ms[i] = (s_benchmark_frames[i].completed - s_benchmark_frames[i].posted) / ticks_per_ms;
+		total_draws += s_benchmark_frames[i].draws;
+	}
+
+	std::string json = fmt::format("{{\n  \"dump\": \"{}\",\n  \"serial\": \"{}\",\n  \"crc\": \"{:08X}\",\n",
+		GSDumpReplayerEscapeJSON(s_benchmark_dump_name), GSDumpReplayerEscapeJSON(s_dump_file->GetSerial()),
+		s_dump_file->GetCRC());
+	json += fmt::format("  \"renderer\": \"{}\",\n  \"loops\": {},\n  \"frames\": {},\n  \"seconds\": {:.4f},\n  \"fps\": {:.3f},\n",
+		Pcsx2Config::GSOptions::GetRendererName(GSConfig.Renderer), s_benchmark_loops, count, seconds,
+		(seconds > 0.0) ? (count / seconds) : 0.0);
+	if (!s_hash_baseline_path.empty())
+		json += fmt::format("  \"frame_hash_mismatches\": {},\n", s_frame_hash_mismatches);
+	json += fmt::format("  \"draws\": {},\n  \"cpu_ms\": {},\n  \"mtgs_queue_ms\": {},\n  \"per_frame\": [\n",
+		total_draws, GSDumpReplayerFormatTimeStats(GSDumpReplayerGetTimeStats(cpu_ms)),
+		GSDumpReplayerFormatTimeStats(GSDumpReplayerGetTimeStats(queue_ms)));
+	for (u32 i = 0; i < count; i++)
+	{
+		json += fmt::format("    {{\"cpu_ms\": {:.4f}, \"mtgs_queue_ms\": {:.4f}, \"draws\": {}}}{}\n",
+			cpu_ms[i], queue_ms[i], s_benchmark_frames[i].draws, (i + 1 < count) ? "," : "");
+	}
+	json += "  ]\n}\n";
+
+	Error error;
+	if (!FileSystem::WriteStringToFile(s_benchmark_report_path.c_str(), json, &error))
+	{
+		Console.Error("(GSDumpReplayer) Failed to write benchmark report '%s': %s", s_benchmark_report_path.c_str(),
+			error.GetDescription().c_str());
+		return;
+	}
+
+	Console.WriteLn("(GSDumpReplayer) %u frames in %.3f s, %.2f FPS. Report written to '%s'.", count, seconds,
+		(seconds > 0.0) ? (count / seconds) : 0.0, s_benchmark_report_path.c_str());
+}
+
+static u64 GSDumpReplayerGetMemoryFootprint()
+{
+#ifdef __APPLE__
+	task_vm_info_data_t info;
+	mach_msg_type_number_t count = TASK_VM_INFO_COUNT;
+	if (task_info(mach_task_self(), TASK_VM_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+		return 0;
+	return info.phys_footprint;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+	return static_cast<u64>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+static std::string GSDumpReplayerEscapeCSV(std::string_view str)
+{
+	if (str.find_first_of(",\"\n") == std::string_view::npos)
+		return std::string(str);
+
+	std::string ret = "\"";
+	for (const char ch : str)
+	{
+		if (ch == '"')
+			ret += '"';
+		ret += ch;
+	}
+	ret += '"';
+	return ret;
+}
+
+static void GSDumpReplayerWriteBatchReport()
+{
+	static constexpr double MB = 1024.0 * 1024.0;
+	const auto fps = [](const BatchResult& result) { return (result.seconds > 0.0) ? (result.frames / result.seconds) : 0.0; };
+
+	std::string report;
+	if (StringUtil::EndsWithNoCase(s_batch_report_path, ".csv"))
+	{
+		report = "dump,loaded,frames,seconds,fps,frame_ms_mean,frame_ms_p50,frame_ms_p95,frame_ms_p99,frame_ms_max,"
+				 "cpu_ms_mean,cpu_ms_p95,draws,tc_source_mb,tc_target_mb,peak_memory_mb,error\n";
+		for (const BatchResult& result : s_batch_results)
+		{
+			report += fmt::format("{},{},{},{:.4f},{:.3f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{:.4f},{},{:.2f},{:.2f},{:.2f},{}\n",
+				GSDumpReplayerEscapeCSV(result.dump), result.loaded ? 1 : 0, result.frames, result.seconds, fps(result),
+				result.frame_ms.mean, result.frame_ms.p50, result.frame_ms.p95, result.frame_ms.p99, result.frame_ms.max,
+				result.cpu_ms.mean, result.cpu_ms.p95, result.draws, result.tc_source_peak / MB, result.tc_target_peak / MB,
+				result.peak_memory / MB, GSDumpReplayerEscapeCSV(result.error));
+		}
+	}
+	else
+	{
+		report = fmt::format("{{\n  \"renderer\": \"{}\",\n  \"frames_per_dump\": {},\n  \"dumps\": [\n",
+			Pcsx2Config::GSOptions::GetRendererName(GSConfig.Renderer), s_batch_frames);
+		for (size_t i = 0; i < s_batch_results.size(); i++)
+		{
+			const BatchResult& result = s_batch_results[i];
+			report += fmt::format("    {{\"dump\": \"{}\", \"loaded\": {}, \"frames\": {}, \"seconds\": {:.4f}, \"fps\": {:.3f}, "
+								  "\"frame_ms\": {}, \"cpu_ms\": {}, \"draws\": {}, \"tc_source_mb\": {:.2f}, \"tc_target_mb\": {:.2f}, "
+								  "\"peak_memory_mb\": {:.2f}, \"error\": \"{}\"}}{}\n",
+				GSDumpReplayerEscapeJSON(result.dump), result.loaded, result.frames, result.seconds, fps(result),
+				GSDumpReplayerFormatTimeStats(result.frame_ms), GSDumpReplayerFormatTimeStats(result.cpu_ms), result.draws,
+				result.tc_source_peak / MB, result.tc_target_peak / MB, result.peak_memory / MB,
+				GSDumpReplayerEscapeJSON(result.error), (i + 1 < s_batch_results.size()) ? "," : "");
+		}
+		report += "  ]\n}\n";
+	}
+
+	Error error;
+	if (!FileSystem::WriteStringToFile(s_batch_report_path.c_str(), report, &error))
+	{
+		Console.Error("(GSDumpReplayer) Failed to write batch report '%s': %s", s_batch_report_path.c_str(),
+			error.GetDescription().c_str());
+		return;
+	}
+
+	Console.WriteLn("(GSDumpReplayer) Ran %zu dumps. Report written to '%s'.", s_batch_results.size(), s_batch_report_path.c_str());
+}
+
+static void GSDumpReplayerFinishBatchDump()
+{
+	MTGS::WaitGS(false);
+
+	BatchResult& result = s_batch_results.emplace_back();
+	result.dump = Path::GetFileName(s_batch_dumps[s_batch_index]);
+	result.loaded = true;
+	result.frames = static_cast<u32>(s_benchmark_frames.size());
+
+	const double ticks_per_ms = static_cast<double>(GetTickFrequency()) / 1000.0;
+	std::vector<double> frame_ms(result.frames), cpu_ms(result.frames);
+	u64 previous = s_benchmark_start_time;
+	for (u32 i = 0; i < result.frames; i++)
+	{
+		const BenchmarkFrame& frame = s_benchmark_frames[i];
+		frame_ms[i] = (frame.completed - previous) / ticks_per_ms;
+		cpu_ms[i] = frame.cpu_ticks / ticks_per_ms;
+		result.draws += frame.draws;
+		previous = frame.completed;
+	}
+
+	result.seconds = (previous - s_benchmark_start_time) / (ticks_per_ms * 1000.0);
+	result.frame_ms = GSDumpReplayerGetTimeStats(std::move(frame_ms));
+	result.cpu_ms = GSDumpReplayerGetTimeStats(std::move(cpu_ms));
+	result.tc_source_peak = s_batch_tc_source_peak;
+	result.tc_target_peak = s_batch_tc_target_peak;
+	result.peak_memory = s_batch_peak_memory;
+	result.error = std::move(s_batch_dump_error);
+	s_batch_dump_error.clear();
+
+	Console.WriteLn("(GSDumpReplayer) [%zu/%zu] %s: %u frames, %.2f FPS, p99 %.2f ms.", s_batch_index + 1, s_batch_dumps.size(),
+		result.dump.c_str(), result.frames, (result.seconds > 0.0) ? (result.frames / result.seconds) : 0.0, result.frame_ms.p99);
+}
+
+static void GSDumpReplayerNextBatchDump()
+{
+	GSDumpReplayerFinishBatchDump();
+
+	// The GS thread is idle after the wait above, so the counters it updates can be reset.
+	s_benchmark_frames.clear();
+	s_benchmark_started = false;
+	s_batch_tc_source_peak = 0;
+	s_batch_tc_target_peak = 0;
+	s_batch_peak_memory = 0;
+
+	// Dumps which fail to load go in the report with no frames and the error.
+	while (++s_batch_index < s_batch_dumps.size())
+	{
+		Error error;
+		if (GSDumpReplayerChangeDump(s_batch_dumps[s_batch_index].c_str(), &error))
+			return;
+
+		Console.Error("(GSDumpReplayer) [%zu/%zu] %s", s_batch_index + 1, s_batch_dumps.size(), error.GetDescription().c_str());
+		BatchResult& result = s_batch_results.emplace_back();
+		result.dump = Path::GetFileName(s_batch_dumps[s_batch_index]);
+		result.error = error.GetDescription();
+	}
+
+	GSDumpReplayerWriteBatchReport();
+	Host::RequestVMShutdown(false, false, false);
+	s_dump_running = false;
+}
+
 static void GSDumpReplayerUpdateFrameLimit()
 {
 	constexpr u32 default_frame_limit = 60;
@@ -258,23 +890,45 @@ static void GSDumpReplayerFrameLimit()
 
 void GSDumpReplayerCpuStep()
 {
+	if (s_batch_dump_done)
+	{
+		s_batch_dump_done = false;
+		GSDumpReplayerNextBatchDump();
+		if (!s_dump_running)
+			return;
+	}
+
 	if (s_needs_state_loaded)
 	{
 		GSDumpReplayerLoadInitialState();
 		s_needs_state_loaded = false;
 	}
 
-	const GSDumpFile::GSData& packet = s_dump_file->GetPackets()[s_current_packet];
-	s_current_packet = (s_current_packet + 1) % static_cast<u32>(s_dump_file->GetPackets().size());
-	if (s_current_packet == 0)
+	GSDumpStream::GSData packet;
+	if (!s_dump_file->Next(&packet))
 	{
+		if (!s_hash_finished)
+			GSDumpReplayerFinishFrameHashes();
+
 		s_dump_frame_number = 0;
 		if (s_dump_loop_count > 0)
 			s_dump_loop_count--;
 		else if (s_dump_loop_count == 0)
 		{
+			if (GSDumpReplayer::IsBenchmarking())
+				GSDumpReplayerWriteBenchmarkReport();
+			Host::RequestVMShutdown(false, false, false);
+			s_dump_running = false;
+			return;
+		}
+
+		s_dump_file->Rewind();
+		if (!s_dump_file->Next(&packet))
+		{
+			Console.Error("(GSDumpReplayer) Dump has no packets.");
 			Host::RequestVMShutdown(false, false, false);
 			s_dump_running = false;
+			return;
 		}
 	}
 
@@ -316,9 +970,24 @@ void GSDumpReplayerCpuStep()
 		case GSDumpTypes::GSType::VSync:
 		{
 			s_dump_frame_number++;
-			GSDumpReplayerUpdateFrameLimit();
-			GSDumpReplayerFrameLimit();
-			MTGS::PostVsyncStart(false);
+			if (GSDumpReplayer::IsBenchmarking() || !s_batch_dumps.empty())
+			{
+				GSDumpReplayerBenchmarkVSync();
+				MTGS::PostVsyncStart(false);
+				GSDumpReplayerBenchmarkMarker();
+			}
+			else
+			{
+				GSDumpReplayerUpdateFrameLimit();
+				GSDumpReplayerFrameLimit();
+				MTGS::PostVsyncStart(false);
+			}
+			GSDumpReplayerQueueFrameHash();
+			if (!s_batch_dumps.empty())
+			{
+				s_batch_peak_memory = std::max(s_batch_peak_memory, GSDumpReplayerGetMemoryFootprint());
+				s_batch_dump_done = (s_benchmark_frames.size() >= s_batch_frames);
+			}
 			VMManager::Internal::VSyncOnCPUThread();
 			if (VMManager::Internal::IsExecutionInterrupted())
 				GSDumpReplayerExitExecution();
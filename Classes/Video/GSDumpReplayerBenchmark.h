@@ -0,0 +1,80 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "common/Pcsx2Types.h"
+
+#include <string>
+#include <vector>
+
+// Extends the GSDumpReplayer interface from pcsx2/GSDumpReplayer.h, which lives in the
+// submodule, with a benchmark mode, frame hashing and batch runs for regression testing.
+//
+// PCSX2GameCore calls ConfigureFromEnvironment() before booting the VM, so these can be
+// switched on when opening a dump from OpenEmu. The environment variables are:
+//   OE_GSDUMP_BLOCK_COMPRESS=<path>     rewrites the dump with GSDumpStream::WriteBlockCompressed()
+//   OE_GSDUMP_BLOCK_COMPRESS_LEVEL=<n>  at that zstd level (3 by default), and replays the copy.
+//   OE_GSDUMP_BENCHMARK=<report path>   calls SetBenchmarkMode() with that report path,
+//   OE_GSDUMP_BENCHMARK_LOOPS=<loops>   replaying the dump that many times (1 by default).
+//   OE_GSDUMP_HASH_BASELINE=<path>      calls SetFrameHashing() with that baseline,
+//   OE_GSDUMP_HASH_UPDATE=1             overwriting it rather than comparing against it.
+//   OE_GSDUMP_BATCH=<path>:<path>...    calls SetBatchMode() with those dumps or directories,
+//   OE_GSDUMP_BATCH_FRAMES=<frames>     running each for that many frames (1000 by default),
+//   OE_GSDUMP_BATCH_REPORT=<path>       and writing the report there, which is required. The
+//                                       first dump is booted instead of the one opened.
+namespace GSDumpReplayer
+{
+	/// Applies the environment variables above to booting \p filename, which is replaced if
+	/// the VM should boot another dump instead. Does nothing if none of them are set.
+	void ConfigureFromEnvironment(std::string* filename);
+
+	/// Replays the dump \p loops times as fast as it will go, with the frame limiter off,
+	/// then writes a JSON report to \p report_path and shuts the VM down. The report has the
+	/// CPU time, MTGS queue time and draw count of every frame, and the overall frame rate.
+	/// Set this before booting the dump. Works with any renderer, including Software and Null.
+	void SetBenchmarkMode(std::string report_path, s32 loops);
+	bool IsBenchmarking();
+
+	/// Reads back and hashes the output after every vsync of the first loop, at the size the
+	/// renderer drew it. Use the Software renderer or 1x upscaling to hash the native output,
+	/// and record and check a baseline with the same settings. When the loop ends the hashes
+	/// are compared against the baseline in \p baseline_path, or saved as the baseline if the
+	/// file doesn't exist yet or \p update_baseline is set. Set this before booting the dump.
+	void SetFrameHashing(std::string baseline_path, bool update_baseline = false);
+
+	/// Frames that differed from (or were missing in) the baseline, once the first loop is done.
+	u32 GetFrameHashMismatches();
+
+	/// Replays every dump in \p paths for \p frames frames each, looping dumps that are shorter,
+	/// without rebooting the VM or recreating the GS device in between. Directories in \p paths
+	/// are searched for dumps. Once the last dump is done, the frame rate, frame time percentiles,
+	/// draw count, texture cache size and peak memory of each are written to \p report_path, as
+	/// CSV if it ends in .csv and JSON otherwise, and the VM shuts down. Replaces benchmark mode.
+	/// Dumps that fail to load are logged and listed in the report with their error, rather than
+	/// reported with a dialog, and the batch carries on with the next one.
+	/// Boot the VM with the first of GetBatchDumps(). Returns false if there were no dumps.
+	bool SetBatchMode(const std::vector<std::string>& paths, u32 frames, std::string report_path);
+	const std::vector<std::string>& GetBatchDumps();
+} // namespace GSDumpReplayer
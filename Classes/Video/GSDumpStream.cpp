@@ -0,0 +1,1157 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "GSDumpStream.h"
+#include "WorkerPool.h"
+
+#include "GS/GSDump.h"
+
+#include "common/Console.h"
+#include "common/Error.h"
+#include "common/FileSystem.h"
+#include "common/StringUtil.h"
+#include "common/Threading.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <lzma.h>
+#include <zstd.h>
+
+GSDumpStream::GSDumpStream() = default;
+
+GSDumpStream::~GSDumpStream() = default;
+
+bool GSDumpStream::ReadHeader(Error* error)
+{
+	u32 state_size;
+	if (ReadHeaderBytes(&m_crc, sizeof(m_crc)) != sizeof(m_crc) ||
+		ReadHeaderBytes(&state_size, sizeof(state_size)) != sizeof(state_size))
+	{
+		Error::SetString(error, "Failed to read header");
+		return false;
+	}
+
+	m_packets_offset = sizeof(m_crc) + sizeof(state_size) + state_size;
+	m_state_data.resize(state_size);
+	if (ReadHeaderBytes(m_state_data.data(), state_size) != state_size)
+	{
+		Error::SetString(error, "Failed to read state data");
+		return false;
+	}
+
+	// Newer dumps start with a header blob in place of the state, followed by the real state.
+	if (m_crc == 0xFFFFFFFFu)
+	{
+		GSDumpHeader header;
+		if (m_state_data.size() < sizeof(header))
+		{
+			Error::SetString(error, "GSDumpHeader is missing");
+			return false;
+		}
+
+		std::memcpy(&header, m_state_data.data(), sizeof(header));
+		if (header.serial_size > 0)
+		{
+			if (header.serial_offset > state_size || (static_cast<u64>(header.serial_offset) + header.serial_size) > state_size)
+			{
+				Error::SetString(error, "Serial is out of bounds");
+				return false;
+			}
+
+			m_serial.assign(reinterpret_cast<const char*>(m_state_data.data()) + header.serial_offset, header.serial_size);
+		}
+
+		m_crc = header.crc;
+		m_packets_offset += header.state_size;
+		m_header_blob = std::move(m_state_data);
+		m_state_data.resize(header.state_size);
+		if (ReadHeaderBytes(m_state_data.data(), header.state_size) != header.state_size)
+		{
+			Error::SetString(error, "Failed to read real state data");
+			return false;
+		}
+	}
+
+	m_regs_data.resize(8192);
+	m_packets_offset += m_regs_data.size();
+	if (ReadHeaderBytes(m_regs_data.data(), m_regs_data.size()) != m_regs_data.size())
+	{
+		Error::SetString(error, "Failed to read registers");
+		return false;
+	}
+
+	return true;
+}
+
+GSDumpStream::PacketResult GSDumpStream::ParsePacket(const u8* data, size_t size, GSData* packet, size_t* packet_size)
+{
+	if (size < 1)
+		return PacketResult::Incomplete;
+
+	size_t header_size = 1;
+	packet->id = static_cast<GSDumpTypes::GSType>(data[0]);
+	packet->path = GSDumpTypes::GSTransferPath::Dummy;
+	switch (packet->id)
+	{
+		case GSDumpTypes::GSType::Transfer:
+		{
+			u32 length;
+			if (size < 6)
+				return PacketResult::Incomplete;
+
+			packet->path = static_cast<GSDumpTypes::GSTransferPath>(data[1]);
+			std::memcpy(&length, data + 2, sizeof(length));
+			packet->length = length;
+			header_size = 6;
+		}
+		break;
+
+		case GSDumpTypes::GSType::VSync:
+			packet->length = 1;
+			break;
+
+		case GSDumpTypes::GSType::ReadFIFO2:
+			packet->length = 4;
+			break;
+
+		case GSDumpTypes::GSType::Registers:
+			packet->length = 8192;
+			break;
+
+		default:
+			return PacketResult::Invalid;
+	}
+
+	if ((size - header_size) < packet->length)
+		return PacketResult::Incomplete;
+
+	packet->data = data + header_size;
+	*packet_size = header_size + packet->length;
+	return PacketResult::OK;
+}
+
+// ----------------------------------------------------------------------------
+//  Uncompressed dumps
+// ----------------------------------------------------------------------------
+
+namespace
+{
+	class GSDumpMappedStream final : public GSDumpStream
+	{
+	public:
+		~GSDumpMappedStream() override
+		{
+			if (m_data)
+				munmap(const_cast<u8*>(m_data), m_size);
+		}
+
+		bool Open(const char* filename, Error* error)
+		{
+			const int fd = open(filename, O_RDONLY);
+			if (fd < 0)
+			{
+				Error::SetErrno(error, "open() failed: ", errno);
+				return false;
+			}
+
+			struct stat sd;
+			if (fstat(fd, &sd) != 0 || sd.st_size <= 0)
+			{
+				Error::SetString(error, "Dump is empty or couldn't be stat()ed");
+				close(fd);
+				return false;
+			}
+
+			void* data = mmap(nullptr, static_cast<size_t>(sd.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd);
+			if (data == MAP_FAILED)
+			{
+				Error::SetErrno(error, "mmap() failed: ", errno);
+				return false;
+			}
+
+			m_data = static_cast<const u8*>(data);
+			m_size = static_cast<size_t>(sd.st_size);
+			madvise(data, m_size, MADV_SEQUENTIAL);
+
+			if (!ReadHeader(error))
+				return false;
+
+			m_pos = m_packets_offset;
+			return true;
+		}
+
+		bool Next(GSData* packet) override
+		{
+			if (m_pos >= m_size)
+				return false;
+
+			size_t packet_size;
+			switch (ParsePacket(m_data + m_pos, m_size - m_pos, packet, &packet_size))
+			{
+				case PacketResult::OK:
+					m_pos += packet_size;
+					return true;
+
+				case PacketResult::Incomplete:
+					// Some dumps out there are missing bytes on the end. Dropping the last packet
+					// is less likely to leave the GS in the middle of a command.
+					if (!m_reported_end)
+						Console.Error("(GSDumpStream) %zu bytes left over at the end, discarding last packet.", m_size - m_pos);
+					break;
+
+				case PacketResult::Invalid:
+					if (!m_reported_end)
+						Console.Error("(GSDumpStream) Unknown packet type %u at offset %zu.", m_data[m_pos], m_pos);
+					break;
+			}
+
+			m_reported_end = true;
+			return false;
+		}
+
+		void Rewind() override
+		{
+			m_pos = m_packets_offset;
+		}
+
+	protected:
+		size_t ReadHeaderBytes(void* dst, size_t size) override
+		{
+			const size_t count = std::min(size, m_size - m_pos);
+			std::memcpy(dst, m_data + m_pos, count);
+			m_pos += count;
+			return count;
+		}
+
+	private:
+		const u8* m_data = nullptr;
+		size_t m_size = 0;
+		size_t m_pos = 0;
+		bool m_reported_end = false;
+	};
+} // namespace
+
+// ----------------------------------------------------------------------------
+//  Compressed dumps
+// ----------------------------------------------------------------------------
+
+namespace
+{
+	/// Decompresses a dump from the start. Read() returns short at the end of the data, or
+	/// on an error.
+	class GSDumpDecoder
+	{
+	public:
+		explicit GSDumpDecoder(FileSystem::ManagedCFilePtr fp)
+			: m_fp(std::move(fp))
+		{
+		}
+		virtual ~GSDumpDecoder() = default;
+
+		/// Goes back to the start of the file.
+		virtual bool Reset() = 0;
+		virtual size_t Read(void* dst, size_t size) = 0;
+
+		/// Reads and throws away \p size bytes.
+		bool Skip(u64 size)
+		{
+			u8 buffer[64 * 1024];
+			while (size > 0)
+			{
+				const size_t count = static_cast<size_t>(std::min<u64>(size, sizeof(buffer)));
+				if (Read(buffer, count) != count)
+					return false;
+				size -= count;
+			}
+			return true;
+		}
+
+	protected:
+		static constexpr size_t InputBufferSize = 256 * 1024;
+
+		FileSystem::ManagedCFilePtr m_fp;
+		u8 m_input[InputBufferSize];
+		bool m_eof = false;
+	};
+
+	class GSDumpXzDecoder final : public GSDumpDecoder
+	{
+	public:
+		using GSDumpDecoder::GSDumpDecoder;
+
+		~GSDumpXzDecoder() override
+		{
+			lzma_end(&m_strm);
+		}
+
+		bool Reset() override
+		{
+			lzma_end(&m_strm);
+			m_strm = LZMA_STREAM_INIT;
+			const lzma_ret ret = lzma_stream_decoder(&m_strm, UINT64_MAX, LZMA_CONCATENATED);
+			if (ret != LZMA_OK)
+			{
+				Console.Error("(GSDumpStream) Error initializing LZMA stream: %d", static_cast<int>(ret));
+				return false;
+			}
+
+			std::rewind(m_fp.get());
+			m_eof = false;
+			m_done = false;
+			return true;
+		}
+
+		size_t Read(void* dst, size_t size) override
+		{
+			m_strm.next_out = static_cast<u8*>(dst);
+			m_strm.avail_out = size;
+			while (m_strm.avail_out > 0 && !m_done)
+			{
+				if (m_strm.avail_in == 0 && !m_eof)
+				{
+					m_strm.next_in = m_input;
+					m_strm.avail_in = std::fread(m_input, 1, sizeof(m_input), m_fp.get());
+					m_eof = (m_strm.avail_in == 0);
+				}
+
+				const lzma_ret ret = lzma_code(&m_strm, m_eof ? LZMA_FINISH : LZMA_RUN);
+				if (ret == LZMA_STREAM_END)
+				{
+					m_done = true;
+				}
+				else if (ret != LZMA_OK)
+				{
+					Console.Error("(GSDumpStream) LZMA decode error: %d", static_cast<int>(ret));
+					m_done = true;
+				}
+			}
+
+			return size - m_strm.avail_out;
+		}
+
+	private:
+		lzma_stream m_strm = LZMA_STREAM_INIT;
+		bool m_done = false;
+	};
+
+	class GSDumpZstdDecoder final : public GSDumpDecoder
+	{
+	public:
+		using GSDumpDecoder::GSDumpDecoder;
+
+		~GSDumpZstdDecoder() override
+		{
+			if (m_stream)
+				ZSTD_freeDStream(m_stream);
+		}
+
+		bool Reset() override
+		{
+			if (!m_stream && !(m_stream = ZSTD_createDStream()))
+			{
+				Console.Error("(GSDumpStream) Failed to create zstd stream.");
+				return false;
+			}
+
+			ZSTD_DCtx_reset(m_stream, ZSTD_reset_session_only);
+			std::rewind(m_fp.get());
+			m_in = {m_input, 0, 0};
+			m_eof = false;
+			return true;
+		}
+
+		size_t Read(void* dst, size_t size) override
+		{
+			ZSTD_outBuffer out = {dst, size, 0};
+			while (out.pos < out.size)
+			{
+				if (m_in.pos == m_in.size && !m_eof)
+				{
+					m_in.size = std::fread(m_input, 1, sizeof(m_input), m_fp.get());
+					m_in.pos = 0;
+					m_eof = (m_in.size == 0);
+				}
+
+				// Once the input has run out, keep going only while there's buffered output.
+				const size_t prev_pos = out.pos;
+				const size_t ret = ZSTD_decompressStream(m_stream, &out, &m_in);
+				if (ZSTD_isError(ret))
+				{
+					Console.Error("(GSDumpStream) zstd decode error: %s", ZSTD_getErrorName(ret));
+					m_eof = true;
+					m_in.pos = m_in.size;
+					break;
+				}
+				if (m_eof && out.pos == prev_pos)
+					break;
+			}
+
+			return out.pos;
+		}
+
+	private:
+		ZSTD_DStream* m_stream = nullptr;
+		ZSTD_inBuffer m_in = {};
+	};
+
+	/// Packets of a compressed dump are decoded into chunks of whole packets by a background
+	/// thread, which stays up to MaxQueuedChunks ahead of the replay. The first chunks are
+	/// kept around for rewinding: when the whole dump fits in CacheBudget it's only decoded
+	/// once, otherwise the cached chunks are replayed while the decoder starts over and seeks
+	/// past them.
+	class GSDumpDecodeStream final : public GSDumpStream
+	{
+	public:
+		explicit GSDumpDecodeStream(std::unique_ptr<GSDumpDecoder> decoder)
+			: m_decoder(std::move(decoder))
+		{
+		}
+
+		~GSDumpDecodeStream() override
+		{
+			if (m_thread.joinable())
+			{
+				{
+					std::unique_lock lock(m_mutex);
+					m_quit = true;
+				}
+				m_cv.notify_all();
+				m_thread.join();
+			}
+		}
+
+		bool Open(Error* error)
+		{
+			if (!m_decoder->Reset())
+			{
+				Error::SetString(error, "Failed to initialize decompressor");
+				return false;
+			}
+
+			if (!ReadHeader(error))
+				return false;
+
+			m_thread = std::thread(&GSDumpDecodeStream::DecoderThread, this);
+			return true;
+		}
+
+		bool Next(GSData* packet) override
+		{
+			while (!m_current || m_packet_index == m_current->packets.size())
+			{
+				if (m_current && m_current->last)
+					return false;
+
+				NextChunk();
+			}
+
+			*packet = m_current->packets[m_packet_index++];
+			return true;
+		}
+
+		void Rewind() override
+		{
+			// Nothing to do until the first chunk has been taken.
+			if (!m_current)
+				return;
+
+			RetireChunk();
+			m_current = nullptr;
+			m_packet_index = 0;
+			m_next_cached = 0;
+			m_caching = false;
+
+			if (!m_cached.empty() && m_cached.back()->last)
+				return;
+
+			// Throw away what was decoded ahead, and start the decoder over after the cache.
+			{
+				std::unique_lock lock(m_mutex);
+				while (!m_queue.empty())
+				{
+					m_free.push_back(std::move(m_queue.front()));
+					m_queue.pop_front();
+				}
+				m_restart_offset = m_packets_offset + m_cached_bytes;
+				m_restart = true;
+			}
+			m_cv.notify_all();
+		}
+
+	protected:
+		size_t ReadHeaderBytes(void* dst, size_t size) override
+		{
+			return m_decoder->Read(dst, size);
+		}
+
+	private:
+		static constexpr size_t ReadSize = 1024 * 1024;
+		static constexpr size_t MaxQueuedChunks = 16;
+		static constexpr size_t CacheBudget = 128 * 1024 * 1024;
+
+		struct Chunk
+		{
+			std::vector<u8> data;
+			std::vector<GSData> packets; ///< Pointing into data.
+			bool last = false; ///< Nothing follows this chunk.
+		};
+
+		/// Done with the current chunk, keep it in the cache or hand it back to the decoder.
+		void RetireChunk()
+		{
+			if (!m_owned)
+				return;
+
+			if (m_caching && (m_cached_bytes + m_owned->data.size()) <= CacheBudget)
+			{
+				m_cached_bytes += m_owned->data.size();
+				m_cached.push_back(std::move(m_owned));
+				m_next_cached = m_cached.size();
+				return;
+			}
+
+			// The cache has to be a run from the start of the dump, so stop at the first miss.
+			m_caching = false;
+			std::unique_lock lock(m_mutex);
+			m_free.push_back(std::move(m_owned));
+		}
+
+		void NextChunk()
+		{
+			RetireChunk();
+			m_packet_index = 0;
+
+			// Replaying the cache after a rewind.
+			if (m_next_cached < m_cached.size())
+			{
+				m_current = m_cached[m_next_cached++].get();
+				return;
+			}
+
+			{
+				std::unique_lock lock(m_mutex);
+				m_cv.wait(lock, [this]() { return !m_queue.empty(); });
+				m_owned = std::move(m_queue.front());
+				m_queue.pop_front();
+			}
+			m_cv.notify_all();
+			m_current = m_owned.get();
+		}
+
+		void DecoderThread()
+		{
+			Threading::SetNameOfCurrentThread("GS Dump Decoder");
+
+			std::vector<u8> carry;
+			bool finished = false;
+			for (;;)
+			{
+				std::unique_ptr<Chunk> chunk;
+				{
+					std::unique_lock lock(m_mutex);
+					m_cv.wait(lock, [this, finished]() {
+						return m_quit || m_restart || (!finished && m_queue.size() < MaxQueuedChunks);
+					});
+					if (m_quit)
+						return;
+
+					if (m_restart)
+					{
+						m_restart = false;
+						finished = false;
+						carry.clear();
+
+						const u64 offset = m_restart_offset;
+						lock.unlock();
+						const bool seeked = m_decoder->Reset() && m_decoder->Skip(offset);
+						lock.lock();
+						if (!seeked)
+						{
+							// Decoding on from the wrong place would feed the GS garbage, so end
+							// the replay after the cached part instead.
+							Console.Error("(GSDumpStream) Failed to seek back to the cached position.");
+							if (m_restart || m_quit)
+								continue;
+
+							if (!m_free.empty())
+							{
+								chunk = std::move(m_free.back());
+								m_free.pop_back();
+							}
+							else
+							{
+								chunk = std::make_unique<Chunk>();
+							}
+
+							chunk->data.clear();
+							chunk->packets.clear();
+							chunk->last = true;
+							m_queue.push_back(std::move(chunk));
+							finished = true;
+							lock.unlock();
+							m_cv.notify_all();
+						}
+						continue;
+					}
+
+					if (!m_free.empty())
+					{
+						chunk = std::move(m_free.back());
+						m_free.pop_back();
+					}
+				}
+
+				if (!chunk)
+					chunk = std::make_unique<Chunk>();
+
+				DecodeChunk(chunk.get(), &carry);
+				finished = chunk->last;
+
+				// A rewind while decoding means this chunk is stale.
+				{
+					std::unique_lock lock(m_mutex);
+					if (m_restart)
+						m_free.push_back(std::move(chunk));
+					else
+						m_queue.push_back(std::move(chunk));
+				}
+				m_cv.notify_all();
+			}
+		}
+
+		/// Fills \p chunk with the next run of whole packets. The start of a packet which
+		/// didn't fit goes in \p carry, for the next chunk.
+		void DecodeChunk(Chunk* chunk, std::vector<u8>* carry)
+		{
+			chunk->data.assign(carry->begin(), carry->end());
+			chunk->packets.clear();
+			chunk->last = false;
+			carry->clear();
+
+			size_t consumed = 0;
+			for (;;)
+			{
+				const size_t pos = chunk->data.size();
+				chunk->data.resize(pos + ReadSize);
+				const size_t read = m_decoder->Read(chunk->data.data() + pos, ReadSize);
+				chunk->data.resize(pos + read);
+				const bool eof = (read < ReadSize);
+
+				// Only parse once the data is done growing, since packets point into it.
+				consumed = 0;
+				chunk->packets.clear();
+				PacketResult result = PacketResult::OK;
+				GSData packet;
+				size_t packet_size;
+				while ((result = ParsePacket(chunk->data.data() + consumed, chunk->data.size() - consumed, &packet, &packet_size)) == PacketResult::OK)
+				{
+					chunk->packets.push_back(packet);
+					consumed += packet_size;
+				}
+
+				if (result == PacketResult::Invalid)
+				{
+					Console.Error("(GSDumpStream) Unknown packet type %u, stopping there.", chunk->data[consumed]);
+					chunk->last = true;
+					break;
+				}
+
+				if (eof)
+				{
+					if (consumed < chunk->data.size())
+						Console.Error("(GSDumpStream) %zu bytes left over at the end, discarding last packet.", chunk->data.size() - consumed);
+					chunk->last = true;
+					break;
+				}
+
+				// A packet bigger than the chunk so far, keep reading.
+				if (!chunk->packets.empty())
+					break;
+			}
+
+			// Shrinking doesn't reallocate, so the packets stay put.
+			carry->assign(chunk->data.begin() + consumed, chunk->data.end());
+			chunk->data.resize(consumed);
+			if (chunk->last)
+				carry->clear();
+		}
+
+		std::unique_ptr<GSDumpDecoder> m_decoder;
+
+		std::thread m_thread;
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		std::deque<std::unique_ptr<Chunk>> m_queue;
+		std::vector<std::unique_ptr<Chunk>> m_free;
+		u64 m_restart_offset = 0;
+		bool m_restart = false;
+		bool m_quit = false;
+
+		// Replay side.
+		Chunk* m_current = nullptr;
+		std::unique_ptr<Chunk> m_owned; ///< m_current, when it came from the decoder.
+		size_t m_packet_index = 0;
+		std::vector<std::unique_ptr<Chunk>> m_cached;
+		size_t m_cached_bytes = 0;
+		size_t m_next_cached = 0;
+		bool m_caching = true;
+	};
+} // namespace
+
+// ----------------------------------------------------------------------------
+//  Block-compressed dumps
+// ----------------------------------------------------------------------------
+
+namespace
+{
+	// zstd's seekable format: the seek table goes in a skippable frame at the end, and ends
+	// with a footer of the frame count, a descriptor byte and the seekable magic number.
+	static constexpr u32 SKIPPABLE_FRAME_MAGIC = 0x184D2A5E;
+	static constexpr u32 SEEKABLE_MAGIC = 0x8F92EAB1;
+	static constexpr size_t SEEK_TABLE_FOOTER_SIZE = 9;
+	static constexpr u8 SEEK_TABLE_CHECKSUM_FLAG = 0x80;
+
+	/// The first frame holds the header, state and registers, every frame after it a run of
+	/// whole packets. Frames are decoded on the shared worker pool, up to MaxBlocksAhead past
+	/// the one being replayed. When all of them fit in CacheBudget they're kept after the first
+	/// loop, otherwise a rewind just starts decoding from the first packet frame again.
+	class GSDumpBlockStream final : public GSDumpStream
+	{
+	public:
+		enum class OpenResult : u8
+		{
+			OK,
+			NotBlocked, ///< No seek table, or not laid out like a block dump.
+			Error,
+		};
+
+		~GSDumpBlockStream() override
+		{
+			WaitForDecodes();
+			if (m_file_data)
+				munmap(const_cast<u8*>(m_file_data), m_file_size);
+		}
+
+		OpenResult Open(const char* filename, Error* error)
+		{
+			const int fd = open(filename, O_RDONLY);
+			if (fd < 0)
+			{
+				Error::SetErrno(error, "open() failed: ", errno);
+				return OpenResult::Error;
+			}
+
+			struct stat sd;
+			if (fstat(fd, &sd) != 0 || sd.st_size <= static_cast<off_t>(SEEK_TABLE_FOOTER_SIZE))
+			{
+				close(fd);
+				return OpenResult::NotBlocked;
+			}
+
+			void* data = mmap(nullptr, static_cast<size_t>(sd.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+			close(fd);
+			if (data == MAP_FAILED)
+			{
+				Error::SetErrno(error, "mmap() failed: ", errno);
+				return OpenResult::Error;
+			}
+
+			m_file_data = static_cast<const u8*>(data);
+			m_file_size = static_cast<size_t>(sd.st_size);
+			if (!ReadSeekTable())
+				return OpenResult::NotBlocked;
+
+			// The header has to be a frame of its own, or the packet frames won't line up.
+			const FrameEntry& first = m_frames[0];
+			m_header_data.resize(first.size);
+			const size_t ret = ZSTD_decompress(m_header_data.data(), first.size, m_file_data + first.offset, first.compressed_size);
+			if (ZSTD_isError(ret) || ret != first.size || !ReadHeader(error) || m_packets_offset != first.size)
+			{
+				Console.Warning("(GSDumpStream) Dump has a seek table, but isn't split into packet blocks.");
+				return OpenResult::NotBlocked;
+			}
+
+			m_header_data = {};
+			u64 total_size = 0;
+			for (const FrameEntry& frame : m_frames)
+				total_size += frame.size;
+			m_keep_blocks = (total_size <= CacheBudget);
+			m_blocks.resize(m_frames.size());
+			m_current_block = 1;
+			m_next_submit = 1;
+			return OpenResult::OK;
+		}
+
+		bool Next(GSData* packet) override
+		{
+			while (m_current_block < m_frames.size())
+			{
+				Block* block = WaitForBlock(m_current_block);
+				if (m_packet_index < block->packets.size())
+				{
+					*packet = block->packets[m_packet_index++];
+					return true;
+				}
+
+				if (block->failed)
+					return false;
+
+				// Packets from the previous block are no longer handed out, so it can go.
+				if (!m_keep_blocks)
+					m_blocks[m_current_block].reset();
+
+				m_current_block++;
+				m_packet_index = 0;
+			}
+
+			return false;
+		}
+
+		void Rewind() override
+		{
+			if (!m_keep_blocks)
+			{
+				WaitForDecodes();
+				for (std::unique_ptr<Block>& block : m_blocks)
+					block.reset();
+				m_next_submit = 1;
+			}
+
+			m_current_block = 1;
+			m_packet_index = 0;
+		}
+
+	protected:
+		size_t ReadHeaderBytes(void* dst, size_t size) override
+		{
+			const size_t count = std::min(size, m_header_data.size() - m_header_pos);
+			std::memcpy(dst, m_header_data.data() + m_header_pos, count);
+			m_header_pos += count;
+			return count;
+		}
+
+	private:
+		static constexpr size_t CacheBudget = 128 * 1024 * 1024;
+
+		struct FrameEntry
+		{
+			u64 offset;
+			u32 compressed_size;
+			u32 size;
+		};
+
+		struct Block
+		{
+			std::vector<u8> data;
+			std::vector<GSData> packets; ///< Pointing into data.
+			bool ready = false;
+			bool failed = false; ///< Didn't decompress, or didn't end on a packet boundary.
+		};
+
+		bool ReadSeekTable()
+		{
+			const u8* footer = m_file_data + m_file_size - SEEK_TABLE_FOOTER_SIZE;
+			u32 num_frames, magic;
+			std::memcpy(&num_frames, footer, sizeof(num_frames));
+			const u8 descriptor = footer[4];
+			std::memcpy(&magic, footer + 5, sizeof(magic));
+			if (magic != SEEKABLE_MAGIC || num_frames == 0)
+				return false;
+
+			const size_t entry_size = (descriptor & SEEK_TABLE_CHECKSUM_FLAG) ? 12 : 8;
+			const u64 table_size = 8 + static_cast<u64>(num_frames) * entry_size + SEEK_TABLE_FOOTER_SIZE;
+			if (table_size > m_file_size)
+				return false;
+
+			const u8* table = m_file_data + m_file_size - table_size;
+			u32 frame_magic;
+			std::memcpy(&frame_magic, table, sizeof(frame_magic));
+			if (frame_magic != SKIPPABLE_FRAME_MAGIC)
+				return false;
+
+			m_frames.resize(num_frames);
+			u64 offset = 0;
+			for (u32 i = 0; i < num_frames; i++)
+			{
+				FrameEntry& frame = m_frames[i];
+				std::memcpy(&frame.compressed_size, table + 8 + i * entry_size, sizeof(frame.compressed_size));
+				std::memcpy(&frame.size, table + 8 + i * entry_size + 4, sizeof(frame.size));
+				frame.offset = offset;
+				offset += frame.compressed_size;
+			}
+
+			return (offset + table_size) == m_file_size;
+		}
+
+		/// Queues decodes up to MaxBlocksAhead past \p index, and waits for \p index.
+		Block* WaitForBlock(size_t index)
+		{
+			const size_t max_ahead = WorkerPool::GetShared().GetThreadCount() * 2;
+			for (; m_next_submit < m_frames.size() && m_next_submit <= (index + max_ahead); m_next_submit++)
+			{
+				if (!m_blocks[m_next_submit])
+					SubmitDecode(m_next_submit);
+			}
+
+			Block* block = m_blocks[index].get();
+			std::unique_lock lock(m_mutex);
+			m_cv.wait(lock, [block]() { return block->ready; });
+			return block;
+		}
+
+		void SubmitDecode(size_t index)
+		{
+			m_blocks[index] = std::make_unique<Block>();
+			Block* block = m_blocks[index].get();
+			const FrameEntry& frame = m_frames[index];
+			{
+				std::unique_lock lock(m_mutex);
+				m_in_flight++;
+			}
+
+			WorkerPool::GetShared().Submit([this, block, &frame, index]() {
+				block->data.resize(frame.size);
+				const size_t ret = ZSTD_decompress(block->data.data(), frame.size, m_file_data + frame.offset, frame.compressed_size);
+				bool failed = (ZSTD_isError(ret) || ret != frame.size);
+				if (failed)
+				{
+					Console.Error("(GSDumpStream) Failed to decompress block %zu.", index);
+				}
+				else
+				{
+					size_t pos = 0, packet_size;
+					GSData packet;
+					while (ParsePacket(block->data.data() + pos, block->data.size() - pos, &packet, &packet_size) == PacketResult::OK)
+					{
+						block->packets.push_back(packet);
+						pos += packet_size;
+					}
+
+					if (pos != block->data.size())
+					{
+						Console.Error("(GSDumpStream) Block %zu ends partway through a packet, stopping there.", index);
+						failed = true;
+					}
+				}
+
+				{
+					std::unique_lock lock(m_mutex);
+					block->failed = failed;
+					block->ready = true;
+					m_in_flight--;
+				}
+				m_cv.notify_all();
+			});
+		}
+
+		void WaitForDecodes()
+		{
+			std::unique_lock lock(m_mutex);
+			m_cv.wait(lock, [this]() { return m_in_flight == 0; });
+		}
+
+		const u8* m_file_data = nullptr;
+		size_t m_file_size = 0;
+		std::vector<FrameEntry> m_frames;
+
+		std::vector<u8> m_header_data;
+		size_t m_header_pos = 0;
+
+		std::mutex m_mutex;
+		std::condition_variable m_cv;
+		u32 m_in_flight = 0;
+
+		std::vector<std::unique_ptr<Block>> m_blocks; ///< By frame, null when not decoded.
+		size_t m_current_block = 0;
+		size_t m_next_submit = 0;
+		size_t m_packet_index = 0;
+		bool m_keep_blocks = false;
+	};
+} // namespace
+
+std::unique_ptr<GSDumpStream> GSDumpStream::Open(const char* filename, Error* error)
+{
+	const bool xz = StringUtil::EndsWithNoCase(filename, ".xz");
+	const bool zst = StringUtil::EndsWithNoCase(filename, ".zst");
+	if (!xz && !zst)
+	{
+		std::unique_ptr<GSDumpMappedStream> stream = std::make_unique<GSDumpMappedStream>();
+		if (!stream->Open(filename, error))
+			return {};
+		return stream;
+	}
+
+	// Dumps with a seek table can be decompressed in parallel, the rest are a single stream.
+	if (zst)
+	{
+		std::unique_ptr<GSDumpBlockStream> stream = std::make_unique<GSDumpBlockStream>();
+		switch (stream->Open(filename, error))
+		{
+			case GSDumpBlockStream::OpenResult::OK:
+				return stream;
+
+			case GSDumpBlockStream::OpenResult::Error:
+				return {};
+
+			case GSDumpBlockStream::OpenResult::NotBlocked:
+				break;
+		}
+	}
+
+	FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(filename, "rb", error);
+	if (!fp)
+		return {};
+
+	std::unique_ptr<GSDumpDecoder> decoder;
+	if (xz)
+		decoder = std::make_unique<GSDumpXzDecoder>(std::move(fp));
+	else
+		decoder = std::make_unique<GSDumpZstdDecoder>(std::move(fp));
+
+	std::unique_ptr<GSDumpDecodeStream> stream = std::make_unique<GSDumpDecodeStream>(std::move(decoder));
+	if (!stream->Open(error))
+		return {};
+	return stream;
+}
+
+bool GSDumpStream::WriteBlockCompressed(const char* src_filename, const char* dst_filename, int level, Error* error)
+{
+	std::unique_ptr<GSDumpStream> src = Open(src_filename, error);
+	if (!src)
+		return false;
+
+	FileSystem::ManagedCFilePtr fp = FileSystem::OpenManagedCFile(dst_filename, "wb", error);
+	if (!fp)
+		return false;
+
+	const auto append = [](std::vector<u8>* buffer, const void* data, size_t size) {
+		buffer->insert(buffer->end(), static_cast<const u8*>(data), static_cast<const u8*>(data) + size);
+	};
+	const auto append_u32 = [&append](std::vector<u8>* buffer, u32 value) { append(buffer, &value, sizeof(value)); };
+
+	// Blocks are compressed a batch at a time, then written out in order.
+	WorkerPool& pool = WorkerPool::GetShared();
+	const u32 batch_size = pool.GetThreadCount() * 2;
+	std::vector<std::vector<u8>> blocks(batch_size);
+	std::vector<std::vector<u8>> compressed(batch_size);
+	std::vector<u8> seek_table;
+	u32 num_frames = 0;
+
+	const auto write_blocks = [&](u32 count) {
+		pool.ParallelFor(count, [&](u32 i) {
+			compressed[i].resize(ZSTD_compressBound(blocks[i].size()));
+			const size_t ret = ZSTD_compress(compressed[i].data(), compressed[i].size(), blocks[i].data(), blocks[i].size(), level);
+			compressed[i].resize(ZSTD_isError(ret) ? 0 : ret);
+		});
+
+		for (u32 i = 0; i < count; i++)
+		{
+			if (compressed[i].empty() || std::fwrite(compressed[i].data(), compressed[i].size(), 1, fp.get()) != 1)
+				return false;
+
+			append_u32(&seek_table, static_cast<u32>(compressed[i].size()));
+			append_u32(&seek_table, static_cast<u32>(blocks[i].size()));
+			blocks[i].clear();
+			num_frames++;
+		}
+
+		return true;
+	};
+
+	std::vector<u8>& header = blocks[0];
+	if (!src->m_header_blob.empty())
+	{
+		append_u32(&header, 0xFFFFFFFFu);
+		append_u32(&header, static_cast<u32>(src->m_header_blob.size()));
+		append(&header, src->m_header_blob.data(), src->m_header_blob.size());
+	}
+	else
+	{
+		append_u32(&header, src->m_crc);
+		append_u32(&header, static_cast<u32>(src->m_state_data.size()));
+	}
+	append(&header, src->m_state_data.data(), src->m_state_data.size());
+	append(&header, src->m_regs_data.data(), src->m_regs_data.size());
+
+	bool result = write_blocks(1);
+
+	u32 filled = 0;
+	GSData packet;
+	while (result && src->Next(&packet))
+	{
+		std::vector<u8>& block = blocks[filled];
+		block.push_back(static_cast<u8>(packet.id));
+		if (packet.id == GSDumpTypes::GSType::Transfer)
+		{
+			block.push_back(static_cast<u8>(packet.path));
+			append_u32(&block, static_cast<u32>(packet.length));
+		}
+		append(&block, packet.data, packet.length);
+
+		if (block.size() >= BlockSize && ++filled == batch_size)
+		{
+			result = write_blocks(batch_size);
+			filled = 0;
+		}
+	}
+
+	if (result)
+		result = write_blocks(filled + (blocks[filled].empty() ? 0 : 1));
+
+	if (result)
+	{
+		std::vector<u8> frame;
+		append_u32(&frame, SKIPPABLE_FRAME_MAGIC);
+		append_u32(&frame, static_cast<u32>(seek_table.size() + SEEK_TABLE_FOOTER_SIZE));
+		append(&frame, seek_table.data(), seek_table.size());
+		append_u32(&frame, num_frames);
+		frame.push_back(0);
+		append_u32(&frame, SEEKABLE_MAGIC);
+		result = (std::fwrite(frame.data(), frame.size(), 1, fp.get()) == 1 && std::fflush(fp.get()) == 0);
+	}
+
+	fp.reset();
+	if (!result)
+	{
+		Error::SetStringFmt(error, "Failed to compress or write '{}'", dst_filename);
+		FileSystem::DeleteFilePath(dst_filename);
+		return false;
+	}
+
+	Console.WriteLn("(GSDumpStream) Wrote '%s' as %u blocks.", dst_filename, num_frames);
+	return true;
+}
@@ -0,0 +1,101 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "GS/GSLzma.h"
+
+#include "common/Pcsx2Types.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+class Error;
+
+/// Serves the packets of a GS dump one at a time instead of loading the whole dump up front
+/// like GSDumpFile::ReadFile. Uncompressed dumps are mapped and packets point straight into
+/// the mapping. Compressed dumps are decoded on a background thread, a bounded distance
+/// ahead of the replay, and block-compressed dumps (see WriteBlockCompressed()) on every core.
+class GSDumpStream
+{
+public:
+	using GSData = GSDumpFile::GSData;
+
+	/// Reads the header, state and registers, and gets the packets going. Picks the format
+	/// from the extension, like GSDumpFile::OpenGSDump.
+	static std::unique_ptr<GSDumpStream> Open(const char* filename, Error* error);
+
+	virtual ~GSDumpStream();
+
+	const std::string& GetSerial() const { return m_serial; }
+	u32 GetCRC() const { return m_crc; }
+
+	const std::vector<u8>& GetRegsData() const { return m_regs_data; }
+	const std::vector<u8>& GetStateData() const { return m_state_data; }
+
+	/// Fetches the next packet, or returns false at the end of the dump. The packet's data
+	/// stays valid until the next call to Next() or Rewind().
+	virtual bool Next(GSData* packet) = 0;
+
+	/// Goes back to the first packet.
+	virtual void Rewind() = 0;
+
+	/// Rewrites any dump as a block-compressed .gs.zst: the header and state in one zstd frame,
+	/// then the packets in independently compressed frames of about BlockSize bytes, followed
+	/// by a seek table in zstd's seekable format. To anything else it's a plain zstd dump.
+	/// The capture code in the submodule still writes single-stream dumps, so this converter
+	/// is the only source of block-compressed ones. Their load time against single-stream
+	/// dumps hasn't been measured yet.
+	static bool WriteBlockCompressed(const char* src_filename, const char* dst_filename, int level, Error* error);
+
+	static constexpr size_t BlockSize = 4 * 1024 * 1024;
+
+protected:
+	GSDumpStream();
+
+	/// Reads bytes from the start of the dump, before the packets.
+	virtual size_t ReadHeaderBytes(void* dst, size_t size) = 0;
+
+	bool ReadHeader(Error* error);
+
+	enum class PacketResult : u8
+	{
+		OK,
+		Incomplete, ///< Ran out of data partway through the packet.
+		Invalid,
+	};
+
+	/// Parses the packet at the start of \p data, and how many bytes it takes up.
+	static PacketResult ParsePacket(const u8* data, size_t size, GSData* packet, size_t* packet_size);
+
+	std::string m_serial;
+	u32 m_crc = 0;
+	std::vector<u8> m_regs_data;
+	std::vector<u8> m_state_data;
+	std::vector<u8> m_header_blob; ///< GSDumpHeader and what follows it, on newer dumps.
+
+	/// Where the packets start, in uncompressed bytes from the start of the dump.
+	u64 m_packets_offset = 0;
+};
@@ -0,0 +1,126 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "WorkerPool.h"
+
+#include <algorithm>
+
+WorkerPool::WorkerPool(u32 num_threads)
+{
+	if (num_threads == 0)
+		num_threads = std::max(std::thread::hardware_concurrency(), 1u);
+
+	m_threads.reserve(num_threads);
+	for (u32 i = 0; i < num_threads; i++)
+		m_threads.emplace_back(&WorkerPool::WorkerThread, this);
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_shutdown = true;
+	}
+	m_task_cv.notify_all();
+
+	for (std::thread& thread : m_threads)
+		thread.join();
+}
+
+void WorkerPool::Submit(std::function<void()> task)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_tasks.push_back(std::move(task));
+		m_pending++;
+	}
+	m_task_cv.notify_one();
+}
+
+void WorkerPool::Wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done_cv.wait(lock, [this]() { return m_pending == 0; });
+}
+
+void WorkerPool::ParallelFor(u32 count, const std::function<void(u32)>& func)
+{
+	if (count == 0)
+		return;
+
+	// Not worth the handoff for a single item.
+	if (count == 1 || m_threads.size() == 1)
+	{
+		for (u32 i = 0; i < count; i++)
+			func(i);
+		return;
+	}
+
+	// Track our own items rather than using Wait(), so other users of the pool don't hold
+	// us up, and so this is safe to call from inside a task on a different pool.
+	std::mutex done_mutex;
+	std::condition_variable done_cv;
+	u32 remaining = count;
+
+	for (u32 i = 0; i < count; i++)
+	{
+		Submit([&func, &done_mutex, &done_cv, &remaining, i]() {
+			func(i);
+
+			std::lock_guard<std::mutex> lock(done_mutex);
+			if (--remaining == 0)
+				done_cv.notify_one();
+		});
+	}
+
+	std::unique_lock<std::mutex> lock(done_mutex);
+	done_cv.wait(lock, [&remaining]() { return remaining == 0; });
+}
+
+WorkerPool& WorkerPool::GetShared()
+{
+	static WorkerPool s_pool;
+	return s_pool;
+}
+
+void WorkerPool::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	for (;;)
+	{
+		m_task_cv.wait(lock, [this]() { return m_shutdown || !m_tasks.empty(); });
+		if (m_tasks.empty())
+			return;
+
+		std::function<void()> task = std::move(m_tasks.front());
+		m_tasks.pop_front();
+		lock.unlock();
+
+		task();
+
+		lock.lock();
+		if (--m_pending == 0)
+			m_done_cv.notify_all();
+	}
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2026, OpenEmu Team
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions are met:
+//     * Redistributions of source code must retain the above copyright
+//       notice, this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright
+//       notice, this list of conditions and the following disclaimer in the
+//       documentation and/or other materials provided with the distribution.
+//     * Neither the name of the OpenEmu Team nor the
+//       names of its contributors may be used to endorse or promote products
+//       derived from this software without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY OpenEmu Team ''AS IS'' AND ANY
+// EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+// WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+// DISCLAIMED. IN NO EVENT SHALL OpenEmu Team BE LIABLE FOR ANY
+// DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+// (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+// LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND
+// ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+
+#include "common/Pcsx2Types.h"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/// Small fixed-size thread pool for splitting bulk work (compression, decompression, mixing)
+/// across the host's cores. Tasks are run in submission order, on whichever worker is free.
+class WorkerPool
+{
+public:
+	/// Creates a pool with \p num_threads workers, or one per host core if zero.
+	explicit WorkerPool(u32 num_threads = 0);
+	~WorkerPool();
+
+	WorkerPool(const WorkerPool&) = delete;
+	WorkerPool& operator=(const WorkerPool&) = delete;
+
+	u32 GetThreadCount() const { return static_cast<u32>(m_threads.size()); }
+
+	/// Queues a task. Use Wait() to block until everything queued so far has finished.
+	void Submit(std::function<void()> task);
+
+	/// Blocks until every submitted task has completed.
+	void Wait();
+
+	/// Runs func(0) .. func(count - 1) across the pool and waits for all of them.
+	void ParallelFor(u32 count, const std::function<void(u32)>& func);
+
+	/// Process-wide pool sized to the host's core count, created on first use.
+	static WorkerPool& GetShared();
+
+private:
+	void WorkerThread();
+
+	std::vector<std::thread> m_threads;
+	std::deque<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_task_cv;
+	std::condition_variable m_done_cv;
+	u32 m_pending = 0;
+	bool m_shutdown = false;
+};